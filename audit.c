@@ -0,0 +1,100 @@
+#include "audit.h"   // Uključujemo header file s deklaracijama i HAL funkcijama
+
+_Static_assert(sizeof(AuditRecord) == 8, "AuditRecord mora imati 8 bajtova");
+
+// - Prsten zapisa (jedan pisac = glavna petlja, jedan čitač = DMA)
+// Zapisi između log_tail i log_head čekaju slanje; DMA čita izravno iz prstena,
+// pa log_tail napreduje tek kad je prijenos gotov (u prekidu).
+static AuditRecord log_buf[AUDIT_LOG_SIZE];
+static volatile uint16_t log_head;      // sljedeće slobodno mjesto (piše samo glavna petlja)
+static volatile uint16_t log_tail;      // najstariji neposlani zapis (piše samo prekid)
+static uint16_t log_seq;                // redni broj sljedećeg zapisa
+static uint32_t log_dropped;            // broj odbačenih zapisa
+
+// - Stanje prijenosa
+static UART_HandleTypeDef *audit_uart;  // UART za slanje zapisa
+static volatile uint8_t tx_busy;        // 1 dok je DMA prijenos u tijeku
+static uint16_t tx_count;               // broj zapisa u prijenosu koji je u tijeku
+static volatile uint8_t tx_fails;       // uzastopni neuspjeli prijenosi (AUDIT_TX_RETRIES = odloženo)
+
+// - Inicijalizacija
+void Audit_Init(UART_HandleTypeDef *huart) {
+    audit_uart = huart;
+    log_head = 0;
+    log_tail = 0;
+    log_seq = 0;
+    log_dropped = 0;
+    tx_busy = 0;
+    tx_count = 0;
+    tx_fails = 0;
+}
+
+// - Dodavanje zapisa (samo glavna petlja)
+void Audit_Record(uint8_t type, uint8_t attempt) {
+    Audit_RecordValue(type, attempt, HAL_GetTick());
+}
+
+void Audit_RecordValue(uint8_t type, uint8_t attempt, uint32_t value) {
+    uint16_t head = log_head;
+    uint16_t seq = log_seq++;
+    if ((uint16_t)(head - log_tail) >= AUDIT_LOG_SIZE) {   // prsten je pun → ne čekamo
+        log_dropped++;
+        return;
+    }
+    AuditRecord *r = &log_buf[head & (AUDIT_LOG_SIZE - 1)];
+    r->tick = value;
+    r->seq = seq;
+    r->type = type;
+    r->attempt = attempt;
+    __DMB();                    // zapis mora biti u RAM-u prije nego ga DMA smije čitati
+    log_head = head + 1;
+    tx_fails = 0;               // novi zapis: slanje (i ono odloženo) opet se pokušava
+}
+
+// - Pokretanje slanja (glavna petlja)
+void Audit_Poll(void) {
+    if (tx_busy || audit_uart == 0 || tx_fails >= AUDIT_TX_RETRIES) return;
+
+    uint16_t tail = log_tail;
+    uint16_t pending = (uint16_t)(log_head - tail);
+    if (pending == 0) return;
+
+    // DMA šalje neprekinut blok: do kraja polja, ostatak ide u sljedećem prijenosu
+    uint16_t start = tail & (AUDIT_LOG_SIZE - 1);
+    uint16_t n = pending;
+    if (n > AUDIT_LOG_SIZE - start) n = AUDIT_LOG_SIZE - start;
+
+    tx_count = n;
+    tx_busy = 1;
+    if (HAL_UART_Transmit_DMA(audit_uart, (uint8_t *)&log_buf[start], n * sizeof(AuditRecord)) != HAL_OK) {
+        tx_busy = 0;            // UART zauzet ili greška → pokušaj opet u sljedećem krugu
+        tx_fails++;
+    }
+}
+
+uint16_t Audit_Free(void) {
+    return AUDIT_LOG_SIZE - (uint16_t)(log_head - log_tail);
+}
+
+uint8_t Audit_Busy(void) {
+    return tx_busy || (log_head != log_tail && tx_fails < AUDIT_TX_RETRIES);
+}
+
+uint32_t Audit_Dropped(void) {
+    return log_dropped;
+}
+
+// - HAL callback: DMA prijenos gotov → oslobodi poslane zapise
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart != audit_uart) return;
+    log_tail = log_tail + tx_count;
+    tx_fails = 0;
+    tx_busy = 0;
+}
+
+// - HAL callback: greška na UART-u → zapisi ostaju u prstenu i šalju se ponovno
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    if (huart != audit_uart) return;
+    if (tx_fails < AUDIT_TX_RETRIES) tx_fails++;
+    tx_busy = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef __AUDIT_H__        // Ako __AUDIT_H__ nije već definiran...
+#define __AUDIT_H__        // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog UART_HandleTypeDef i HAL_UART_Transmit_DMA
+#include "stm32f4xx_hal.h"
+
+// --- Dnevnik pristupa (audit log) ---
+// Zapisi se spremaju u prsten u RAM-u i u pozadini šalju preko UART-a s DMA-om.
+// Upis zapisa je nekoliko naredbi i nikad ne čeka; ako je prsten pun, zapis se
+// odbacuje i broji (Audit_Dropped), a slanje se nastavlja kad se oslobodi mjesto.
+
+// Broj zapisa u prstenu (mora biti potencija broja 2)
+#ifndef AUDIT_LOG_SIZE
+#define AUDIT_LOG_SIZE  64
+#endif
+
+// Nakon ovoliko uzastopnih neuspjelih prijenosa (DMA se ne pokrene ili UART javi
+// grešku) slanje se odlaže: zapisi ostaju u prstenu, ali Audit_Busy() više ne drži
+// uređaj budnim. Sljedeći novi zapis pokreće nove pokušaje.
+#define AUDIT_TX_RETRIES   4
+
+// Vrste zapisa
+#define AUDIT_EV_CORRECT   1   // ispravna lozinka, brava otključana
+#define AUDIT_EV_WRONG     2   // pogrešna lozinka
+#define AUDIT_EV_LOCKOUT   3   // previše grešaka → zaključano
+#define AUDIT_EV_PIN_CHG   4   // lozinka promijenjena
+#define AUDIT_EV_HW_RESET  5   // pritisnuto tipkalo PC13
+#define AUDIT_EV_SERVICE   6   // servisni akord na tipkovnici
+#define AUDIT_EV_DURESS    7   // akord prisile (tihi alarm)
+#define AUDIT_EV_PROF      8   // statistika profiliranja (vidi prof.h), nije događaj pristupa
+#define AUDIT_EV_PIN_STORE 9   // nova lozinka nije spremljena u flash (vrijedi samo do reseta)
+#define AUDIT_EV_USERS_OFF 10  // tablica korisnika isključena: glavna lozinka sadrži tipku predaje
+
+// Jedan zapis: 8 bajtova, na UART ide binarno (little-endian) točno ovim redom
+typedef struct {
+    uint32_t tick;      // HAL_GetTick() u trenutku događaja (AUDIT_EV_PROF: izmjerena vrijednost)
+    uint16_t seq;       // redni broj; raste i za odbačene zapise pa se rupe vide na računalu
+    uint8_t type;       // AUDIT_EV_*
+    uint8_t attempt;    // broj uzastopnih pogrešnih pokušaja (AUDIT_EV_PROF: sonda << 5 | polje)
+} AuditRecord;
+
+// Prototipovi funkcija za dnevnik pristupa
+//
+// Audit_Init()
+// - Prazni prsten i pamti UART preko kojeg se zapisi šalju (npr. &huart2)
+//
+// Audit_Record()
+// - Dodaje zapis u prsten; poziva se samo iz glavne petlje, ne blokira
+//
+// Audit_RecordValue()
+// - Kao Audit_Record, ali umjesto HAL_GetTick() u zapis upisuje zadanu vrijednost
+//
+// Audit_Free()
+// - Broj slobodnih mjesta u prstenu
+//
+// Audit_Poll()
+// - Poziva se iz glavne petlje: ako UART miruje, a u prstenu ima zapisa,
+//   pokreće DMA prijenos najvećeg neprekinutog bloka zapisa
+//
+// Audit_Busy()
+// - 1 dok je DMA prijenos u tijeku ili u prstenu ima neposlanih zapisa
+// - Nakon AUDIT_TX_RETRIES neuspjelih prijenosa zaredom neposlani zapisi ne
+//   računaju dok ne stigne novi (pokvaren UART ne smije spriječiti STOP)
+//
+// Audit_Dropped()
+// - Broj zapisa odbačenih jer je prsten bio pun
+void Audit_Init(UART_HandleTypeDef *huart);
+void Audit_Record(uint8_t type, uint8_t attempt);
+void Audit_RecordValue(uint8_t type, uint8_t attempt, uint32_t value);
+uint16_t Audit_Free(void);
+void Audit_Poll(void);
+uint8_t Audit_Busy(void);
+uint32_t Audit_Dropped(void);
+
+#endif // __AUDIT_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,87 @@
+#include "clock.h"     // Uključujemo header file s deklaracijama i HAL funkcijama
+#include "main.h"      // Error_Handler()
+#include "i2c.h"       // hi2c1 (LCD)
+#include "usart.h"     // huart2 (dnevnik pristupa)
+#include "i2c_bus.h"   // I2cBus_AnyBusy()
+#include "audit.h"     // Audit_Busy()
+#include "pattern.h"   // Pattern_Busy(), Pattern_Retime()
+#include "timebase.h"  // Timebase_Retime()
+
+static ClockProfile profile = CLOCK_IDLE;   // SystemClock_Config() kreće s CLOCK_IDLE
+
+// - Ponovno izračunaj djelitelje I2C1 i USART2 iz novog PCLK1
+static void clock_retime(uint32_t i2c_hz) {
+    hi2c1.Init.ClockSpeed = i2c_hz;
+    hi2c1.Init.DutyCycle = I2C_DUTYCYCLE_2;
+    if (HAL_I2C_Init(&hi2c1) != HAL_OK) Error_Handler();   // CCR/TRISE iz PCLK1
+    if (HAL_UART_Init(&huart2) != HAL_OK) Error_Handler(); // BRR iz PCLK1 (baud ostaje isti)
+    Pattern_Retime();                                      // PSC TIM1 iz PCLK2 (APB2 /1 u oba profila)
+    Timebase_Retime();                                     // PSC TIM5 iz PCLK1 (×2 uz APB1 /2)
+}
+
+// - HSI → PLL 84 MHz
+static void clock_burst(void) {
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+
+    __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE2); // VOS se mijenja dok je PLL ugašen
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+    osc.HSIState = RCC_HSI_ON;
+    osc.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+    osc.PLL.PLLState = RCC_PLL_ON;
+    osc.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+    osc.PLL.PLLM = 16;                       // 16 MHz / 16 = 1 MHz na ulazu VCO-a
+    osc.PLL.PLLN = 336;                      // VCO = 336 MHz
+    osc.PLL.PLLP = RCC_PLLP_DIV4;            // SYSCLK = 84 MHz
+    osc.PLL.PLLQ = 7;                        // 48 MHz (USB/SDIO, ovdje se ne koristi)
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK) Error_Handler();
+
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    clk.AHBCLKDivider = RCC_SYSCLK_DIV1;     // HCLK = 84 MHz
+    clk.APB1CLKDivider = RCC_HCLK_DIV2;      // PCLK1 = 42 MHz (najviše dopušteno)
+    clk.APB2CLKDivider = RCC_HCLK_DIV1;      // PCLK2 = 84 MHz
+    if (HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_2) != HAL_OK) Error_Handler();
+}
+
+// - PLL → HSI: prvo prebaci SYSCLK, tek onda ugasi PLL i spusti naponsku skalu
+static void clock_idle(void) {
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+    clk.AHBCLKDivider = RCC_SYSCLK_DIV4;     // HCLK = 4 MHz
+    clk.APB1CLKDivider = RCC_HCLK_DIV1;
+    clk.APB2CLKDivider = RCC_HCLK_DIV1;
+    if (HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_0) != HAL_OK) Error_Handler();
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+    osc.HSIState = RCC_HSI_ON;
+    osc.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+    osc.PLL.PLLState = RCC_PLL_OFF;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK) Error_Handler();
+
+    __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE3);
+}
+
+// - Promjena profila (samo kad I2C, UART i TIM1 miruju)
+uint8_t Clock_SetProfile(ClockProfile p) {
+    if (p == profile) return 1;
+    if (I2cBus_AnyBusy() || Audit_Busy() || Pattern_Busy()) return 0;   // prijenos ili uzorak u tijeku → ne diraj takt
+
+    if (p == CLOCK_BURST) {
+        clock_burst();
+        clock_retime(CLOCK_I2C_BURST_HZ);
+    } else {
+        clock_idle();
+        clock_retime(CLOCK_I2C_IDLE_HZ);
+    }
+    profile = p;
+    return 1;
+}
+
+ClockProfile Clock_GetProfile(void) {
+    return profile;
+}
@@ -0,0 +1,41 @@
+#ifndef __CLOCK_H__        // Ako __CLOCK_H__ nije već definiran...
+#define __CLOCK_H__        // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog RCC/PWR/I2C/UART tipova i funkcija
+#include "stm32f4xx_hal.h"
+
+// --- Profili takta ---
+// CLOCK_IDLE  → HSI 16 MHz, AHB /4 (HCLK = PCLK1 = 4 MHz), naponska skala 3,
+//               bez wait-stateova, I2C1 100 kHz. Ovo postavlja i SystemClock_Config()
+//               (nakon reseta i nakon buđenja iz STOP-a).
+// CLOCK_BURST → PLL iz HSI (M=16, N=336, P=4 → 84 MHz), naponska skala 2,
+//               2 wait-statea, APB1 /2 (42 MHz), I2C1 400 kHz (Fast mode).
+//
+// Profil se mijenja samo kad ni I2C ni UART prijenos ni uzorak na TIM1 nije u tijeku,
+// jer im se nakon promjene takta ponovno izračunaju djelitelji (HAL_I2C_Init,
+// HAL_UART_Init, Pattern_Retime, Timebase_Retime).
+// HAL_RCC_ClockConfig() sam ponovno podesi SysTick na 1 ms (HAL_InitTick), pa
+// HAL_GetTick(), HAL_Delay() i scheduler nastavljaju bez skoka.
+
+#define CLOCK_I2C_IDLE_HZ   100000U   // I2C1 u CLOCK_IDLE (Standard mode)
+#define CLOCK_I2C_BURST_HZ  400000U   // I2C1 u CLOCK_BURST (Fast mode)
+
+typedef enum {
+    CLOCK_IDLE = 0,
+    CLOCK_BURST
+} ClockProfile;
+
+// Prototipovi funkcija
+//
+// Clock_SetProfile()
+// - Prebacuje na zadani profil i ponovno podešava I2C1 i USART2
+// - Vraća 1 ako je profil aktivan, 0 ako su I2C sabirnica, dnevnik ili uzorak još zauzeti (pokušaj kasnije)
+//
+// Clock_GetProfile() - trenutni profil
+//
+// U STOP smije samo iz CLOCK_IDLE: buđenje ide kroz SystemClock_Config(), koji
+// postavlja upravo taj profil, pa I2C1 i USART2 ostaju ispravno podešeni.
+uint8_t Clock_SetProfile(ClockProfile p);
+ClockProfile Clock_GetProfile(void);
+
+#endif // __CLOCK_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,238 @@
+#include "cred.h"      // Uključujemo header file s deklaracijama i HAL funkcijama
+#include "keypad_layout.h" // KEYPAD_KEYMAP i KEYPAD_KEY_ENTER: koje se lozinke mogu upisati
+#include <stddef.h>    // offsetof
+#include <string.h>    // memcpy, memcmp, memchr
+
+// Raspored sektora: zaglavlje, pa utori (rezerva je odmah iza zadnjeg pretinca)
+#define CRED_HDR_MAGIC   0U
+#define CRED_HDR_SEED    4U
+#define CRED_HDR_LENS    8U
+#define CRED_SLOT_OFS    16U
+#define CRED_LIVE        0x5AU      // bajt stanja: korisnik vrijedi
+#define CRED_REVOKED     0x00U      // bajt stanja: opozvan
+#define CRED_EMPTY       0xFFFFFFFFU
+
+_Static_assert(sizeof(CredEntry) == 8, "CredEntry mora biti 8 bajtova (2 riječi)");
+_Static_assert(!(KEYPAD_KEY_ENTER >= '0' && KEYPAD_KEY_ENTER <= '9') && !(KEYPAD_KEY_ENTER >= 'A' && KEYPAD_KEY_ENTER <= 'C'),
+               "tipka predaje ne smije biti znak lozinke");
+_Static_assert(CRED_SLOT_OFS + CRED_SLOTS * sizeof(CredEntry) <= CRED_SECTOR_SIZE,
+               "tablica ne stane u sektor");
+
+// - Zaglavlje pročitano pri pokretanju
+static uint8_t formatted;     // magic je upisan
+static uint32_t seed;         // seed hasha (iz zaglavlja)
+static uint32_t lens;         // maska duljina (bit n = 0 → postoji lozinka od n znakova)
+
+static uint32_t cred_rd32(uintptr_t addr) {
+    return *(const volatile uint32_t *)addr;
+}
+
+static uintptr_t cred_slot(uint32_t slot) {
+    return CRED_ADDR + CRED_SLOT_OFS + (uintptr_t)slot * sizeof(CredEntry);
+}
+
+static uint8_t cred_program(uint32_t type, uintptr_t addr, uint32_t data) {
+    return HAL_FLASH_Program(type, addr, data) == HAL_OK;
+}
+
+// - Miješanje bitova (završni korak MurmurHash3)
+static uint32_t cred_mix(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16;
+    return h;
+}
+
+// - Lozinka → kod (4 bita po znaku); vraća 0 za nedopušten znak ili duljinu
+// Neiskorišteni znakovi ostaju 0xF, pa kod sam određuje i duljinu lozinke.
+static uint8_t cred_encode(const char *pin, uint8_t len, uint32_t *code) {
+    uint32_t c = CRED_EMPTY;
+    uint8_t ok = (len >= CRED_PIN_MIN && len <= CRED_PIN_MAX);
+    if (len > CRED_PIN_MAX) len = CRED_PIN_MAX;
+    for (uint8_t i = 0; i < len; i++) {
+        char k = pin[i];
+        uint32_t v = (k >= '0' && k <= '9') ? (uint32_t)(k - '0') :
+                     (k >= 'A' && k <= 'C') ? (uint32_t)(k - 'A' + 10) : 0xFU;
+        ok &= (v != 0xFU);
+        c &= ~(0xFU << (4U * i)) | (v << (4U * i));
+    }
+    *code = c;
+    return ok;
+}
+
+// - Može li se lozinka upisati i predati na ovom rasporedu tipkovnice: svaki znak mora
+// postojati, a bez tipke predaje unos se predaje sam na CRED_PIN_MIN znakova (duljina
+// glavne lozinke), pa dulje i kraće lozinke ne bi nikad prošle
+static uint8_t cred_typeable(const char *pin, uint8_t len) {
+    static const char keys[] = KEYPAD_KEYMAP;
+    if (KEYPAD_KEY_ENTER == 0 && len != CRED_PIN_MIN) return 0;
+    for (uint8_t i = 0; i < len; i++) {
+        if (!memchr(keys, pin[i], sizeof(keys) - 1)) return 0;
+    }
+    return 1;
+}
+
+static uint8_t cred_check(uint32_t code, uint8_t len, uint8_t role) {
+    return (uint8_t)cred_mix(code ^ ((uint32_t)len << 8) ^ ((uint32_t)role << 16));
+}
+
+// - Hash → pretinac (množenje umjesto dijeljenja, CRED_BUCKETS ne mora biti potencija broja 2)
+static uint32_t cred_reduce(uint32_t h) {
+    return (uint32_t)(((uint64_t)h * CRED_BUCKETS) >> 32);
+}
+
+// - Dva pretinca za kod (uvijek različita)
+static void cred_buckets(uint32_t code, uint32_t *b1, uint32_t *b2) {
+    uint32_t h = cred_mix(code ^ seed);
+    *b1 = cred_reduce(h);
+    *b2 = cred_reduce(cred_mix(h ^ 0x5BD1E995U));
+    if (*b2 == *b1) *b2 = (*b1 + 1U) % CRED_BUCKETS;
+}
+
+// - Traženje bez grananja: uvijek 2 × CRED_BUCKET_SLOTS + CRED_STASH utora
+// Vraća broj utora + 1 (0 = nema), a u *role ulogu nađenog korisnika.
+static uint32_t cred_find(uint32_t code, uint8_t len, uint8_t *role) {
+    uint32_t b[2], hit = 0, r = 0;
+    cred_buckets(code, &b[0], &b[1]);
+    for (uint32_t i = 0; i < 2U * CRED_BUCKET_SLOTS + CRED_STASH; i++) {
+        uint32_t slot = (i < 2U * CRED_BUCKET_SLOTS)
+                        ? b[i / CRED_BUCKET_SLOTS] * CRED_BUCKET_SLOTS + i % CRED_BUCKET_SLOTS
+                        : CRED_BUCKETS * CRED_BUCKET_SLOTS + (i - 2U * CRED_BUCKET_SLOTS);
+        CredEntry e;
+        memcpy(&e, (const void *)cred_slot(slot), sizeof(e));
+        uint32_t diff = (e.code ^ code) | (uint32_t)(e.len ^ len) | (uint32_t)(e.state ^ CRED_LIVE) |
+                        (uint32_t)(e.check ^ cred_check(e.code, e.len, e.role));
+        uint32_t m = ((diff | (0U - diff)) >> 31) ^ 1U;    // 1 samo ako je diff == 0
+        hit |= (slot + 1U) & (0U - m);
+        r |= e.role & (0U - m);
+    }
+    *role = (uint8_t)(r & (0U - (uint32_t)formatted));
+    return hit & (0U - (uint32_t)formatted);
+}
+
+// - Je li utor prazan (obje riječi 0xFF; prekinut upis ostavlja utor neupotrebljiv)
+static uint8_t cred_free(uint32_t slot) {
+    uintptr_t a = cred_slot(slot);
+    return cred_rd32(a) == CRED_EMPTY && cred_rd32(a + 4U) == CRED_EMPTY;
+}
+
+// - Prvi upis: obriši sektor ako treba, upiši seed pa magic
+static uint8_t cred_format(void) {
+    uint8_t blank = 1;
+    for (uint32_t i = 0; i < CRED_SECTOR_SIZE && blank; i += 4) {
+        blank = (cred_rd32(CRED_ADDR + i) == CRED_EMPTY);
+    }
+    if (!blank) {
+        FLASH_EraseInitTypeDef erase = {0};
+        uint32_t bad_sector;
+        erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+        erase.Banks = FLASH_BANK_1;
+        erase.Sector = CRED_SECTOR;
+        erase.NbSectors = 1;
+        erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+        WRITE_REG(IWDG->KR, 0xAAAAU);             // osvježi IWDG (ako radi) prije brisanja od 1–2 s
+        if (HAL_FLASHEx_Erase(&erase, &bad_sector) != HAL_OK) return 0;
+    }
+    if (!cred_program(FLASH_TYPEPROGRAM_WORD, CRED_ADDR + CRED_HDR_SEED, CRED_SEED)) return 0;
+    if (!cred_program(FLASH_TYPEPROGRAM_WORD, CRED_ADDR + CRED_HDR_MAGIC, CRED_MAGIC)) return 0;
+    formatted = 1;
+    seed = CRED_SEED;
+    lens = CRED_EMPTY;
+    return 1;
+}
+
+void Cred_Init(void) {
+    formatted = (cred_rd32(CRED_ADDR + CRED_HDR_MAGIC) == CRED_MAGIC);
+    seed = cred_rd32(CRED_ADDR + CRED_HDR_SEED);
+    lens = formatted ? cred_rd32(CRED_ADDR + CRED_HDR_LENS) : CRED_EMPTY;
+}
+
+uint8_t Cred_Verify(const char *pin, uint8_t len) {
+    uint32_t code;
+    uint8_t role;
+    uint8_t ok = cred_encode(pin, len, &code);
+    uint32_t slot = cred_find(code, len, &role);
+    if (!ok || !slot) return 0;
+
+    if (role == CRED_ROLE_ONCE) {                  // jednokratna: opozovi odmah nakon uporabe
+        HAL_FLASH_Unlock();
+        cred_program(FLASH_TYPEPROGRAM_BYTE, cred_slot(slot - 1U) + offsetof(CredEntry, state), CRED_REVOKED);
+        HAL_FLASH_Lock();
+    }
+    return role;
+}
+
+uint8_t Cred_Add(const char *pin, uint8_t len, uint8_t role) {
+    uint32_t code, b1, b2;
+    uint8_t found_role;
+    if (!cred_encode(pin, len, &code) || role < CRED_ROLE_USER || role > CRED_ROLE_ONCE) return 0;
+    if (!cred_typeable(pin, len)) return 0;
+    if (cred_find(code, len, &found_role)) return 0;   // ista lozinka → ne bi se znalo tko je ušao
+
+    HAL_FLASH_Unlock();
+    if (!formatted && !cred_format()) {
+        HAL_FLASH_Lock();
+        return 0;
+    }
+
+    // Slobodniji od dva pretinca (ravnomjerno punjenje), pa rezerva
+    cred_buckets(code, &b1, &b2);
+    int32_t slot = -1;
+    uint8_t best = 0;
+    for (uint32_t i = 0; i < 2U * CRED_BUCKET_SLOTS; i++) {
+        uint32_t b = (i < CRED_BUCKET_SLOTS) ? b1 : b2;
+        uint32_t s = b * CRED_BUCKET_SLOTS + i % CRED_BUCKET_SLOTS;
+        if (!cred_free(s)) continue;
+        uint8_t n = 0;                             // broj slobodnih utora u tom pretincu
+        for (uint32_t k = 0; k < CRED_BUCKET_SLOTS; k++) n += cred_free(b * CRED_BUCKET_SLOTS + k);
+        if (n > best) {
+            best = n;
+            slot = (int32_t)s;
+        }
+    }
+    for (uint32_t i = 0; slot < 0 && i < CRED_STASH; i++) {
+        if (cred_free(CRED_BUCKETS * CRED_BUCKET_SLOTS + i)) slot = (int32_t)(CRED_BUCKETS * CRED_BUCKET_SLOTS + i);
+    }
+
+    // Bit duljine ide prije utora: nestanak napajanja između dva upisa ostavi samo višak
+    // bita (bezopasno), a ne korisnika čiju duljinu submit_len ne pokriva (i koji se ne
+    // bi mogao ni ponovno dodati jer ga cred_find već nalazi)
+    uint8_t ok = (slot >= 0);
+    if (ok && (lens & (1UL << len))) {             // prva lozinka ove duljine
+        lens &= ~(1UL << len);
+        ok = cred_program(FLASH_TYPEPROGRAM_WORD, CRED_ADDR + CRED_HDR_LENS, lens);
+    }
+    if (ok) {
+        CredEntry e = { code, len, role, CRED_LIVE, cred_check(code, len, role) };
+        uint32_t w[2];
+        uintptr_t a = cred_slot((uint32_t)slot);
+        memcpy(w, &e, sizeof(w));
+        ok = cred_program(FLASH_TYPEPROGRAM_WORD, a, w[0]) &&
+             cred_program(FLASH_TYPEPROGRAM_WORD, a + 4U, w[1]) &&
+             memcmp((const void *)a, &e, sizeof(e)) == 0;
+    }
+    HAL_FLASH_Lock();
+    return ok;
+}
+
+uint8_t Cred_Revoke(const char *pin, uint8_t len) {
+    uint32_t code;
+    uint8_t role;
+    if (!cred_encode(pin, len, &code)) return 0;
+    uint32_t slot = cred_find(code, len, &role);
+    if (!slot) return 0;
+
+    HAL_FLASH_Unlock();
+    uint8_t ok = cred_program(FLASH_TYPEPROGRAM_BYTE, cred_slot(slot - 1U) + offsetof(CredEntry, state), CRED_REVOKED);
+    HAL_FLASH_Lock();
+    return ok;
+}
+
+uint8_t Cred_MaxLen(void) {
+    for (uint8_t n = CRED_PIN_MAX; n >= CRED_PIN_MIN; n--) {
+        if (!(lens & (1UL << n))) return n;
+    }
+    return 0;
+}
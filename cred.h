@@ -0,0 +1,98 @@
+#ifndef __CRED_H__         // Ako __CRED_H__ nije već definiran...
+#define __CRED_H__         // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog HAL_FLASH funkcija i FLASH_BASE
+#include "stm32f4xx_hal.h"
+#include "flash_layout.h"
+
+// --- Tablica korisničkih lozinaka u flashu (hash indeks s dva pretinca) ---
+// Uz glavnu lozinku brava prihvaća tisuće korisničkih lozinaka duljine 4–8 znakova,
+// svaku s ulogom. Tablica je u prvih 64 KB svog sektora i čita se izravno iz flasha:
+//
+//   [zaglavlje 16 B][pretinac 0: 8 utora][pretinac 1] … [pretinac N-1][rezerva: 16 utora]
+//
+//   zaglavlje: magic (upisan zadnji), seed hasha, maska duljina (bit n obrisan =
+//              možda postoji lozinka od n znakova; briše se prije upisa utora)
+//   utor:      lozinka kodirana po 4 bita na znak, duljina, uloga, stanje (CredEntry)
+//
+// Svaka lozinka ima dva moguća pretinca (dva hasha koda). Dodavanje upisuje u
+// slobodniji od ta dva, a kad su oba puna, u rezervu. Zapisi se nikad ne premještaju
+// (flash ne zna prepisati), pa dodavanje ne traži ponovnu izgradnju tablice.
+// Opoziv samo obriše bajt stanja (1 → 0) na mjestu.
+//
+// Provjera uvijek pročita ista 2 × 8 + 16 utora i usporedi ih bez grananja:
+// trajanje ne ovisi ni o veličini tablice ni o tome je li (i gdje) lozinka nađena.
+//
+// Tablica je puna kad su oba pretinca i rezerva puni (uz dva izbora to je tek kod
+// oko 90 % popunjenosti); tada, ili kad ima previše opozvanih utora, tablicu treba
+// ponovno upisati (obrisati sektor i dodati korisnike).
+//
+// Upis korisnika radi se izvan rada brave: servisni program (ili alat preko SWD-a)
+// pozove Cred_Add()/Cred_Revoke() prije isporuke, kao setup_users() u sim/bench.c.
+// Brava sama tablicu samo čita; s tipkovnice se korisnici ne dodaju ni opozivaju
+// (osim što se CRED_ROLE_ONCE opozove sam nakon prve provjere).
+//
+// Sektor je prvi iza koda, treći od kraja flasha (flash_layout.h; na F401xE sektor 5);
+// provjera da kod ne seže do njega je u main.c (FLASH_APP_SIZE). Brisanje sektora u
+// Cred_Add() (samo nova tablica) zaustavi CPU 1–2 s, kao i kod dnevnika lozinke.
+
+#define CRED_SECTOR            FLASH_CRED_SECTOR
+#define CRED_OFS               FLASH_LAYOUT_OFS(CRED_SECTOR)    // pomak od FLASH_BASE
+#define CRED_ADDR              (FLASH_BASE + CRED_OFS)
+#define CRED_SECTOR_SIZE       FLASH_LAYOUT_SIZE(CRED_SECTOR)   // 128 KB
+
+#define CRED_BUCKETS           1020U            // 16 + (1020 × 8 + 16) × 8 B ≤ 64 KB
+#define CRED_BUCKET_SLOTS      8U
+#define CRED_STASH             16U              // utori rezerve (pregledavaju se uvijek svi)
+#define CRED_SLOTS             (CRED_BUCKETS * CRED_BUCKET_SLOTS + CRED_STASH)
+
+#define CRED_PIN_MIN           4U
+#define CRED_PIN_MAX           8U               // 8 znakova × 4 bita = jedna riječ
+#define CRED_MAGIC             0x43524431U      // "CRD1"
+
+#ifndef CRED_SEED
+#define CRED_SEED              0x9E3779B9U      // seed hasha za novu tablicu
+#endif
+
+// Uloge korisnika
+#define CRED_ROLE_USER         1U               // otključava
+#define CRED_ROLE_ADMIN        2U               // otključava; servisni alat po njoj razlikuje upravitelje
+#define CRED_ROLE_ONCE         3U               // otključava jednom, zatim se sam opozove
+
+// Jedan utor (dvije riječi; prazan utor je sav 0xFF)
+typedef struct {
+    uint32_t code;     // znakovi '0'–'9', 'A'–'C' kao 0–12, po 4 bita od najnižih; ostatak 0xF
+    uint8_t len;       // broj znakova (CRED_PIN_MIN … CRED_PIN_MAX)
+    uint8_t role;      // CRED_ROLE_*
+    uint8_t state;     // CRED_LIVE ili 0x00 (opozvan)
+    uint8_t check;     // zaštita od prekinutog upisa (hash koda, duljine i uloge)
+} CredEntry;
+
+// Prototipovi funkcija
+//
+// Cred_Init()
+// - Pri pokretanju: pročita samo zaglavlje tablice (bez pregleda utora)
+//
+// Cred_Verify()
+// - Vraća ulogu korisnika s lozinkom pin (len znakova) ili 0 ako je nema
+// - Lozinka s ulogom CRED_ROLE_ONCE se nakon uspješne provjere opoziva
+// - Potpis odgovara LockVerifyFn (lock_fsm.h)
+//
+// Cred_Add()
+// - Samo za servisni upis (vidi gore); dodaje korisnika (prvi poziv pripremi sektor); blokira dok flash upisuje (~50 µs)
+// - Vraća 1 ako je dodan, 0 ako lozinka nije ispravna, već postoji ili je tablica puna
+// - Lozinka nije ispravna ni kad je raspored tipkovnice ne može upisati: znak kojeg
+//   nema u KEYPAD_KEYMAP, ili (raspored bez KEYPAD_KEY_ENTER) duljina različita od 4
+//
+// Cred_Revoke()
+// - Samo za servisni upis; opoziva korisnika s lozinkom pin, vraća 1 ako je bio u tablici
+//
+// Cred_MaxLen()
+// - Najdulja lozinka koja je ikad dodana (0 = tablica je prazna)
+void Cred_Init(void);
+uint8_t Cred_Verify(const char *pin, uint8_t len);
+uint8_t Cred_Add(const char *pin, uint8_t len, uint8_t role);
+uint8_t Cred_Revoke(const char *pin, uint8_t len);
+uint8_t Cred_MaxLen(void);
+
+#endif // __CRED_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,48 @@
+#ifndef __FLASH_LAYOUT_H__    // Ako __FLASH_LAYOUT_H__ nije već definiran...
+#define __FLASH_LAYOUT_H__    // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog FLASH_SECTOR_TOTAL (HAL) i FLASH_END (CMSIS zaglavlje čipa)
+#include "stm32f4xx_hal.h"
+
+// --- Raspored flasha, izveden iz čipa za koji se prevodi ---
+// STM32F4 s jednom bankom: sektori 0–3 po 16 KB, sektor 4 od 64 KB, sektori 5 i dalje
+// po 128 KB. Broj sektora (FLASH_SECTOR_TOTAL) i kraj flasha (FLASH_END) daje zaglavlje
+// čipa, pa podaci uvijek idu u zadnje sektore, a ne na fiksne brojeve:
+//
+//   sektor FLASH_SECTOR_TOTAL - 3         tablica korisnika (cred.h)
+//   sektor FLASH_SECTOR_TOTAL - 2 i - 1   dnevnik lozinke (pin_store.h)
+//   sektori ispred njih                   kod (FLASH_APP_SIZE u main.c)
+//
+// Na F401xE (512 KB, 8 sektora) to su sektor 5 i sektori 6 i 7, a kod ima prvih 128 KB.
+//
+// Potreban je čip s barem 8 sektora (F401xE, F411xE, F446 s 512 KB, F405/F407 s 1 MB).
+// F401xC/F411xC (256 KB, 6 sektora) imaju premalo sektora od 128 KB i ne prolaze
+// prevođenje; dvobankovni F42x/F43x imaju drukčiji raspored i zaustavi ih provjera kraja
+// rasporeda. Firmware preveden za veći čip, a upisan u manji, zaustavi pri pokretanju
+// provjera veličine flasha iz FLASHSIZE_BASE (flash_image_fits() u main.c).
+
+#ifndef FLASH_END
+#error "zaglavlje čipa ne definira FLASH_END (odaberi čip, npr. STM32F401xE)"
+#endif
+
+// Pomak sektora n od početka flasha i njegova veličina (u bajtovima)
+#define FLASH_LAYOUT_OFS(n)    ((n) < 4U ? (n) * 0x4000U : (n) == 4U ? 0x10000U : ((n) - 4U) * 0x20000U)
+#define FLASH_LAYOUT_SIZE(n)   ((n) < 4U ? 0x4000U : (n) == 4U ? 0x10000U : 0x20000U)
+
+// Kraj zadnjeg sektora i veličina flasha čipa (0x08000000 je FLASH_BASE na pločici)
+#define FLASH_LAYOUT_END       (FLASH_LAYOUT_OFS(FLASH_SECTOR_TOTAL - 1U) + FLASH_LAYOUT_SIZE(FLASH_SECTOR_TOTAL - 1U))
+#define FLASH_LAYOUT_DEVICE    (FLASH_END - 0x08000000UL + 1U)
+
+#if FLASH_SECTOR_TOTAL < 8
+#error "tablica korisnika i dnevnik lozinke trebaju tri sektora od 128 KB (čip s barem 8 sektora)"
+#endif
+#if FLASH_LAYOUT_END != FLASH_LAYOUT_DEVICE
+#error "raspored sektora ne odgovara veličini flasha čipa (FLASH_END)"
+#endif
+
+// Sektor tablice korisnika i sektori dnevnika lozinke: zadnja tri
+#define FLASH_CRED_SECTOR      (FLASH_SECTOR_TOTAL - 3U)
+#define FLASH_PIN_SECTOR_A     (FLASH_SECTOR_TOTAL - 2U)
+#define FLASH_PIN_SECTOR_B     (FLASH_SECTOR_TOTAL - 1U)
+
+#endif // __FLASH_LAYOUT_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,92 @@
+#include "i2c_bus.h"   // Uključujemo header file s deklaracijama i HAL funkcijama
+
+// Registrirane sabirnice (HAL callback dobije samo I2C handle)
+static I2cBus *buses[I2C_BUS_MAX];
+static uint8_t bus_count;
+
+// - Sabirnica za HAL handle iz callbacka
+static I2cBus *i2c_bus_find(I2C_HandleTypeDef *hi2c) {
+    for (uint8_t i = 0; i < bus_count; i++) {
+        if (buses[i]->hi2c == hi2c) return buses[i];
+    }
+    return NULL;
+}
+
+// - Skini prvi zahtjev iz reda i javi vlasniku (prijenos je gotov ili nije uspio)
+static void i2c_bus_pop(I2cBus *bus, uint8_t ok) {
+    I2cBusReq *r = bus->head;
+    bus->head = r->next;
+    if (!bus->head) bus->tail = NULL;
+    r->next = NULL;
+    r->pending = 0;
+    if (r->done) r->done(r, ok);
+}
+
+// - Pokreni prvi zahtjev iz reda; ako HAL odbije, zahtjev se odbacuje i ide sljedeći
+// (poziva se iz prekida završetka ili iz I2cBus_Submit kad je sabirnica mirovala)
+static void i2c_bus_start(I2cBus *bus) {
+    while (bus->head) {
+        I2cBusReq *r = bus->head;
+#if I2C_BUS_USE_DMA
+        if (HAL_I2C_Master_Transmit_DMA(bus->hi2c, r->addr << 1, r->data, r->len) == HAL_OK) return;
+#else
+        if (HAL_I2C_Master_Transmit_IT(bus->hi2c, r->addr << 1, r->data, r->len) == HAL_OK) return;
+#endif
+        bus->errors++;                 // ne čekamo u prekidu: podaci se gube, red ide dalje
+        i2c_bus_pop(bus, 0);
+    }
+}
+
+// - Inicijalizacija sabirnice (ponovni poziv za isti handle samo obriše red)
+void I2cBus_Init(I2cBus *bus, I2C_HandleTypeDef *hi2c) {
+    bus->hi2c = hi2c;
+    bus->head = NULL;
+    bus->tail = NULL;
+    bus->errors = 0;
+    if (!i2c_bus_find(hi2c) && bus_count < I2C_BUS_MAX) {
+        buses[bus_count++] = bus;
+    }
+}
+
+// - Predaja zahtjeva (glavna petlja)
+void I2cBus_Submit(I2cBus *bus, I2cBusReq *req) {
+    req->next = NULL;
+    req->pending = 1;
+
+    __disable_irq();                   // red dijelimo s prekidom završetka
+    uint8_t idle = (bus->head == NULL);
+    if (idle) bus->head = req;
+    else bus->tail->next = req;
+    bus->tail = req;
+    __enable_irq();
+
+    if (idle) i2c_bus_start(bus);      // ništa nije u tijeku pa prekid ne može ući između
+}
+
+uint8_t I2cBus_Busy(const I2cBus *bus) {
+    return bus->head != NULL;
+}
+
+uint8_t I2cBus_AnyBusy(void) {
+    for (uint8_t i = 0; i < bus_count; i++) {
+        if (buses[i]->head) return 1;
+    }
+    return 0;
+}
+
+// --- HAL callback: DMA/IT prijenos je završen → sljedeći iz reda (poziva se iz prekida) ---
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    I2cBus *bus = i2c_bus_find(hi2c);
+    if (!bus || !bus->head) return;
+    i2c_bus_pop(bus, 1);
+    i2c_bus_start(bus);
+}
+
+// --- HAL callback: greška (npr. NACK) → odbaci zahtjev da red ne zapne ---
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    I2cBus *bus = i2c_bus_find(hi2c);
+    if (!bus || !bus->head) return;
+    bus->errors++;
+    i2c_bus_pop(bus, 0);
+    i2c_bus_start(bus);
+}
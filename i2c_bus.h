@@ -0,0 +1,66 @@
+#ifndef __I2C_BUS_H__      // Ako __I2C_BUS_H__ nije već definiran...
+#define __I2C_BUS_H__      // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog I2C_HandleTypeDef i HAL_I2C funkcija
+#include "stm32f4xx_hal.h"
+
+// --- Zajednička I2C sabirnica s redom prijenosa ---
+// Više uređaja (npr. nekoliko LCD-ova na adresama 0x27, 0x3F, …) dijeli jednu I2C
+// periferiju. Svaki uređaj predaje zahtjev (adresa + buffer) i odmah se vraća;
+// zahtjevi čekaju u FIFO redu i šalju se jedan za drugim preko DMA (ili IT).
+// Sljedeći prijenos pokreće prekid završetka prethodnog, pa glavna petlja nikad
+// ne čeka sabirnicu i paneli se ne izmjenjuju kroz blokirajuće slanje.
+//
+// Ovaj modul jedini definira HAL_I2C_MasterTxCpltCallback i HAL_I2C_ErrorCallback.
+
+// Najviše I2C periferija s arbitrom (I2C1–I2C3)
+#ifndef I2C_BUS_MAX
+#define I2C_BUS_MAX 3
+#endif
+
+// 1 = prijenos preko HAL_I2C_Master_Transmit_DMA (I2Cx_TX DMA mora biti uključen u CubeMX-u)
+// 0 = prijenos preko HAL_I2C_Master_Transmit_IT (samo I2C prekidi)
+#ifndef I2C_BUS_USE_DMA
+#define I2C_BUS_USE_DMA 1
+#endif
+
+// Jedan zahtjev; pripada pozivatelju (npr. jedan po bufferu LCD-a) i ne smije se
+// mijenjati dok je 'pending' 1
+typedef struct I2cBusReq {
+    struct I2cBusReq *next;           // sljedeći u redu (interno)
+    uint8_t *data;                    // bajtovi za slanje
+    uint16_t len;                     // broj bajtova
+    uint8_t addr;                     // 7-bitna adresa uređaja
+    volatile uint8_t pending;         // 1 od predaje do kraja prijenosa
+    void (*done)(struct I2cBusReq *req, uint8_t ok);  // poziva se iz prekida (može biti NULL)
+    void *ctx;                        // pozivateljev kontekst za 'done'
+} I2cBusReq;
+
+// Jedna sabirnica (I2C periferija) s redom zahtjeva
+typedef struct {
+    I2C_HandleTypeDef *hi2c;          // HAL handle (npr. &hi2c1)
+    I2cBusReq *head;                  // prijenos u tijeku (ili NULL)
+    I2cBusReq *tail;                  // zadnji u redu
+    uint32_t errors;                  // prijenosi koji nisu pokrenuti ili su završili greškom
+} I2cBus;
+
+// Prototipovi funkcija
+//
+// I2cBus_Init()
+// - Priprema sabirnicu nad HAL handleom i registrira je za HAL callbackove
+//
+// I2cBus_Submit()
+// - Stavlja zahtjev na kraj reda; ako sabirnica miruje, odmah pokreće prijenos
+// - Poziva se iz glavne petlje, ne blokira
+//
+// I2cBus_Busy()
+// - 1 dok je prijenos u tijeku ili u redu čeka zahtjev
+//
+// I2cBus_AnyBusy()
+// - 1 ako je bilo koja registrirana sabirnica zauzeta (npr. prije promjene takta)
+void I2cBus_Init(I2cBus *bus, I2C_HandleTypeDef *hi2c);
+void I2cBus_Submit(I2cBus *bus, I2cBusReq *req);
+uint8_t I2cBus_Busy(const I2cBus *bus);
+uint8_t I2cBus_AnyBusy(void);
+
+#endif // __I2C_BUS_H__   // završetak zaštite od višestrukog uključivanja
@@ -1,58 +1,258 @@
-#include "keypad.h"   // Uključujemo header file s deklaracijama i HAL funkcijama
-
-// - Definicija pinova za redove i kolone tipkovnice 
-// Tipkovnica 4x4 spojena na GPIOA
-// Redovi: PA0, PA1, PA8, PA9
-// Kolone: PA4, PA5, PA6, PA7
-static const uint16_t rowPins[4] = {GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_8, GPIO_PIN_9};
-static const uint16_t colPins[4] = {GPIO_PIN_4, GPIO_PIN_5, GPIO_PIN_6, GPIO_PIN_7};
-#define KEYPAD_GPIO GPIOA   // cijela tipkovnica je na portu A
-
-// - Matrica tipkovnice 4x4 
-// Mapira kombinaciju (red, kolona) na određeni znak
-static const char keymap[4][4] = {
-    {'1', '2', '3', 'A'},
-    {'4', '5', '6', 'B'},
-    {'7', '8', '9', 'C'},
-    {'*', '0', '#', 'D'}
-};
-
-// - Inicijalizacija tipkovnice 
-// (GPIO pinovi se podešavaju u CubeMX-u kao izlazi/ulazi, pa ovdje ništa ne radimo)
-void Keypad_Init(void) {
-    // Ova funkcija ostaje prazna jer su pinovi konfigurirani u MX_GPIO_Init().
-    // Ako želiš ručno, ovdje bi koristio HAL_GPIO_Init() i podesio row kao output, col kao input.
-}
-
-// - Čitanje pritisnute tipke 
-// Vraća znak tipke ili 0 ako ništa nije pritisnuto
-char Keypad_GetKey(void) {
-    // Prolazimo kroz sve redove jedan po jedan
-    for (int row = 0; row < 4; row++) {
-        // 1) Resetiraj sve redove na LOW (0)
-        for (int r = 0; r < 4; r++)
-            HAL_GPIO_WritePin(KEYPAD_GPIO, rowPins[r], GPIO_PIN_RESET);
-
-        // 2) Aktiviraj samo trenutni red (postavi HIGH = 1)
-        HAL_GPIO_WritePin(KEYPAD_GPIO, rowPins[row], GPIO_PIN_SET);
-
-        // 3) Kratko čekanje da se signal stabilizira (debounce)
-        HAL_Delay(1);
-
-        // 4) Provjeravamo sve kolone
-        for (int col = 0; col < 4; col++) {
-            // Ako je neka kolona HIGH → tipka pritisnuta u tom retku i koloni
-            if (HAL_GPIO_ReadPin(KEYPAD_GPIO, colPins[col]) == GPIO_PIN_SET) {
-                // Čekaj dok korisnik ne otpusti tipku (sprječava višestruki unos)
-                while (HAL_GPIO_ReadPin(KEYPAD_GPIO, colPins[col]) == GPIO_PIN_SET);
-
-                // Vrati znak tipke iz matrice keymap
-                return keymap[row][col];
-            }
-        }
-    }
-
-    // Ako nijedna tipka nije pritisnuta → vrati 0
-    return 0;
-}
-
+#include "keypad.h"   // Uključujemo header file s deklaracijama i HAL funkcijama
+#include "prof.h"     // Mjerenje trajanja (isključeno ako PROF_ENABLE nije 1)
+
+// - Raspored tipkovnice dolazi iz keypad_layout.h (KEYPAD_LAYOUT), pinovi iz KeypadPins
+// Za svaki red Keypad_Init unaprijed izračuna BSRR vrijednost koja jednim upisom
+// spusti sve redove (gornjih 16 bitova) i podigne samo taj red (donjih 16 bitova).
+// Kad su isti pin i u "set" i u "reset" dijelu, "set" ima prednost.
+
+// Znakovi tipki, indeks = bit u maski matrice (red * KEYPAD_COLS + kolona)
+static const char keymap[KEYPAD_KEYS + 1] = KEYPAD_KEYMAP;
+
+_Static_assert(sizeof(KEYPAD_KEYMAP) == KEYPAD_KEYS + 1, "KEYPAD_KEYMAP mora imati KEYPAD_ROWS * KEYPAD_COLS znakova");
+_Static_assert((KEYPAD_ROW_PINS & KEYPAD_COL_PINS) == 0, "redovi i kolone ne smiju dijeliti pin");
+_Static_assert(KEYPAD_COL_SHIFT + KEYPAD_COLS <= 16, "kolone moraju biti unutar porta");
+
+#define KEYPAD_CHORD_USES_ENTER(a, b, code)  || (a) == KEYPAD_KEY_ENTER || (b) == KEYPAD_KEY_ENTER
+_Static_assert(KEYPAD_KEY_ENTER == 0 || !(0 KEYPAD_CHORD_LIST(KEYPAD_CHORD_USES_ENTER)),
+               "tipka predaje ne smije biti u akordu");
+
+// Akordi iz KEYPAD_CHORD_LIST; maske (chord_mask, chord_all u Keypad) izračuna Keypad_Init
+#define KEYPAD_CHORD_KEYS(a, b, code)  {a, b},
+#define KEYPAD_CHORD_CODE(a, b, code)  code,
+static const char chord_keys[KEYPAD_CHORDS][2] = { KEYPAD_CHORD_LIST(KEYPAD_CHORD_KEYS) };
+static const char chord_code[KEYPAD_CHORDS] = { KEYPAD_CHORD_LIST(KEYPAD_CHORD_CODE) };
+
+// Stanje skenera i red događaja su u strukturi Keypad (keypad.h): skener ih mijenja
+// iz prekida, a glavna petlja samo čita red. Tako isti kod skenira više tipkovnica.
+
+// - Stavljanje događaja u red (poziva se samo iz prekida)
+static void queue_push(Keypad *kp, char key, uint8_t type, uint32_t tick) {
+    uint8_t head = kp->q_head;
+    uint8_t next = (head + 1) & (KEYPAD_QUEUE_SIZE - 1);
+    if (next == kp->q_tail) {   // red je pun → događaj odbacujemo, ne čekamo
+        kp->q_dropped++;
+        return;
+    }
+    kp->queue[head].tick = tick;
+    kp->queue[head].key = key;
+    kp->queue[head].type = type;
+    __DMB();                    // događaj mora biti upisan prije nego ga čitač "vidi"
+    kp->q_head = next;
+}
+
+// - Kratko čekanje da se kolone smire nakon promjene reda
+// (pull-down otpornici i kapacitet vodova; nekoliko ciklusa je dovoljno)
+static inline void keypad_settle(void) {
+    for (uint32_t i = 0; i < KEYPAD_SETTLE_NOPS; i++) __NOP();
+}
+
+// - Skeniranje cijele matrice izravno preko registara
+// Po redu: jedan upis u BSRR i jedno čitanje IDR-a, kolone se izdvoje pomakom i maskom.
+// Broj redova je konstanta pri prevođenju pa prevoditelj petlju odmota.
+static KeypadMask keypad_scan_matrix(Keypad *kp) {
+    GPIO_TypeDef *port = kp->pins->port;
+    uint32_t shift = kp->pins->col_shift;
+    KeypadMask raw = 0;
+    for (uint32_t r = 0; r < KEYPAD_ROWS; r++) {
+        WRITE_REG(port->BSRR, kp->row_bsrr[r]);       // samo red r je HIGH
+        keypad_settle();
+        uint32_t cols = (READ_REG(port->IDR) >> shift) & KEYPAD_COL_MASK;
+        raw |= (KeypadMask)(cols << (r * KEYPAD_COLS));
+    }
+    WRITE_REG(port->BSRR, kp->row_all << 16);         // između skeniranja svi redovi LOW
+    return raw;
+}
+
+// - Debounce svih tipki odjednom (vertikalni brojač)
+// Gdje se sirovo stanje razlikuje od potvrđenog, brojač se poveća za 1, inače se obriše.
+// Kad brojač prijeđe preko (2^KEYPAD_DEBOUNCE_BITS skeniranja zaredom), tipka mijenja stanje.
+static void keypad_debounce(Keypad *kp, KeypadMask raw) {
+    KeypadMask delta = raw ^ kp->stable;
+    KeypadMask carry = delta;
+    for (uint32_t i = 0; i < KEYPAD_DEBOUNCE_BITS; i++) {
+        KeypadMask b = kp->vc[i];
+        kp->vc[i] = (b ^ carry) & delta;
+        carry &= b;
+    }
+    kp->stable ^= carry;
+}
+
+// - Uzorak duha: dva reda dijele barem dvije kolone (pravokutnik od 4 tipke)
+// Bez dioda se tada četvrta tipka pojavi iako nije pritisnuta, pa ne znamo koje su prave.
+static uint8_t keypad_ghosted(KeypadMask m) {
+    for (uint32_t r1 = 0; r1 < KEYPAD_ROWS - 1; r1++) {
+        uint32_t c1 = (m >> (r1 * KEYPAD_COLS)) & KEYPAD_COL_MASK;
+        if ((c1 & (c1 - 1)) == 0) continue;       // manje od dvije kolone u redu
+        for (uint32_t r2 = r1 + 1; r2 < KEYPAD_ROWS; r2++) {
+            uint32_t common = c1 & (m >> (r2 * KEYPAD_COLS));
+            if (common & (common - 1)) return 1;
+        }
+    }
+    return 0;
+}
+
+// - Slanje događaja za sve bitove maske
+static void keypad_emit(Keypad *kp, KeypadMask bits, uint8_t type, uint32_t now) {
+    for (uint32_t bit = 0; bits; bit++, bits >>= 1) {
+        if (bits & 1u) queue_push(kp, keymap[bit], type, now);
+    }
+}
+
+// - Rubovi i akordi nad potvrđenim stanjem (svaka 1 ms)
+static void keypad_edges(Keypad *kp) {
+    KeypadMask down = kp->stable;
+    KeypadMask up = (KeypadMask)~down;
+    KeypadMask released = kp->reported & up;  // poslani pritisci koji su otpušteni
+    KeypadMask tapped = kp->pending & up;     // tipke iz akorda otpuštene bez akorda
+    KeypadMask fresh = 0;
+
+    // Uzorak duha: nove pritiske zadrži dok ne nestane, otpuštanja uvijek prolaze
+    uint8_t g = keypad_ghosted(down);
+    if (g && !kp->ghosted) kp->ghost_count++;
+    kp->ghosted = g;
+    if (!g) fresh = down & (KeypadMask)~(kp->reported | kp->pending | kp->consumed);
+
+    kp->consumed &= down;
+    if (!(released | tapped | fresh) && !(kp->pending & down)) return;   // ništa novo, najčešći slučaj
+
+    uint32_t now = HAL_GetTick();
+    keypad_emit(kp, released, KEYPAD_EVENT_RELEASE, now);
+    keypad_emit(kp, tapped, KEYPAD_EVENT_PRESS, now);     // zakašnjeli pritisak pa odmah otpuštanje
+    keypad_emit(kp, tapped, KEYPAD_EVENT_RELEASE, now);
+    keypad_emit(kp, fresh & (KeypadMask)~kp->chord_all, KEYPAD_EVENT_PRESS, now);
+    kp->reported = (kp->reported & (KeypadMask)~released) | (fresh & (KeypadMask)~kp->chord_all);
+    kp->pending = (kp->pending & (KeypadMask)~tapped) | (fresh & kp->chord_all);
+
+    // Akord: točno njegove dvije tipke drže se KEYPAD_CHORD_HOLD_MS
+    for (uint32_t i = 0; i < KEYPAD_CHORDS; i++) {
+        if (down == kp->chord_mask[i] && (kp->pending & kp->chord_mask[i]) == kp->chord_mask[i]) {
+            if (++kp->chord_ticks >= KEYPAD_CHORD_HOLD_MS) {
+                queue_push(kp, chord_code[i], KEYPAD_EVENT_CHORD, now);
+                kp->pending &= (KeypadMask)~kp->chord_mask[i];
+                kp->consumed |= kp->chord_mask[i];
+                kp->chord_ticks = 0;
+            }
+            return;
+        }
+    }
+    kp->chord_ticks = 0;
+}
+
+// - Maska bita za znak tipke (0 ako tipka ne postoji u rasporedu)
+static KeypadMask keypad_key_bit(char key) {
+    for (uint32_t bit = 0; bit < KEYPAD_KEYS; bit++) {
+        if (keymap[bit] == key) return (KeypadMask)1 << bit;
+    }
+    return 0;
+}
+
+// - Inicijalizacija tipkovnice 
+// (GPIO pinovi se podešavaju u CubeMX-u kao izlazi/ulazi, ovdje samo resetiramo skener)
+// kp->pins je ujedno oznaka "spremno" za Keypad_ScanTick: skida se prvi, a postavlja
+// tek kad je sve ostalo upisano, pa SysTick usred inicijalizacije ne skenira napola
+// postavljenu tipkovnicu.
+void Keypad_Init(Keypad *kp, const KeypadPins *pins) {
+    kp->pins = 0;
+    __DMB();                    // prekid od sada vidi da tipkovnica nije spremna
+    kp->row_all = 0;
+    for (uint32_t r = 0; r < KEYPAD_ROWS; r++) kp->row_all |= pins->row_pins[r];
+    for (uint32_t r = 0; r < KEYPAD_ROWS; r++) {
+        kp->row_bsrr[r] = (kp->row_all << 16) | pins->row_pins[r];
+    }
+    kp->col_pins = (uint32_t)KEYPAD_COL_MASK << pins->col_shift;
+
+    for (uint32_t i = 0; i < KEYPAD_DEBOUNCE_BITS; i++) kp->vc[i] = 0;
+    kp->stable = 0;
+    kp->reported = 0;
+    kp->pending = 0;
+    kp->consumed = 0;
+    kp->chord_ticks = 0;
+    kp->ghosted = 0;
+    kp->ghost_count = 0;
+    kp->q_dropped = 0;
+    kp->q_tail = kp->q_head;    // isprazni red događaja
+
+    // Maske akorda iz znakova tipki u rasporedu
+    kp->chord_all = 0;
+    for (uint32_t i = 0; i < KEYPAD_CHORDS; i++) {
+        kp->chord_mask[i] = keypad_key_bit(chord_keys[i][0]) | keypad_key_bit(chord_keys[i][1]);
+        kp->chord_all |= kp->chord_mask[i];
+    }
+
+    // Svi redovi LOW dok ne krene skeniranje
+    WRITE_REG(pins->port->BSRR, kp->row_all << 16);
+
+    __DMB();                    // sva polja upisana prije nego ih prekid "vidi"
+    kp->pins = pins;
+}
+
+// - Jedan korak skeniranja (poziva se iz prekida svake 1 ms)
+// Cijela matrica se očita u nekoliko mikrosekundi pa svaki tick ima svjež
+// snimak svih tipki i nema više čekanja da se redovi izmijene kroz 4 ticka.
+void Keypad_ScanTick(Keypad *kp) {
+    if (!kp->pins) return;      // SysTick radi od HAL_Init, a tipkovnica još nije spojena
+    PROF_BEGIN(SCAN);
+    keypad_debounce(kp, keypad_scan_matrix(kp));
+    keypad_edges(kp);
+    PROF_END(SCAN);
+}
+
+// - Je li tipkovnica mirna: ništa pritisnuto, debounce ne broji, red je prazan
+uint8_t Keypad_Idle(const Keypad *kp) {
+    KeypadMask counting = 0;
+    for (uint32_t i = 0; i < KEYPAD_DEBOUNCE_BITS; i++) counting |= kp->vc[i];
+    return !(kp->stable | kp->reported | kp->pending | kp->consumed | counting) && kp->q_tail == kp->q_head;
+}
+
+// - Čeka li u redu neki događaj
+uint8_t Keypad_Pending(const Keypad *kp) {
+    return kp->q_tail != kp->q_head;
+}
+
+// - Parkiranje za STOP: svi redovi HIGH, pa pritisak bilo koje tipke digne njenu kolonu
+// (SysTick mora biti zaustavljen, inače bi sljedeće skeniranje spustilo redove)
+void Keypad_Park(Keypad *kp) {
+    WRITE_REG(kp->pins->port->BSRR, kp->row_all);
+    keypad_settle();
+}
+
+// - Nastavak skeniranja nakon buđenja: redovi opet LOW između skeniranja
+void Keypad_Resume(Keypad *kp) {
+    WRITE_REG(kp->pins->port->BSRR, kp->row_all << 16);
+}
+
+// - Uzimanje događaja iz reda (glavna petlja, ne blokira)
+uint8_t Keypad_PollEvent(Keypad *kp, KeypadEvent *ev) {
+    uint8_t tail = kp->q_tail;
+    if (tail == kp->q_head) return 0; // nema događaja
+
+    *ev = kp->queue[tail];
+    __DMB();                          // događaj je pročitan prije nego oslobodimo mjesto
+    kp->q_tail = (tail + 1) & (KEYPAD_QUEUE_SIZE - 1);
+    return 1;
+}
+
+// - Čitanje pritisnute tipke 
+// Vraća znak sljedećeg pritiska ili 0 ako u redu nema pritiska
+char Keypad_GetKey(Keypad *kp) {
+    KeypadEvent ev;
+    while (Keypad_PollEvent(kp, &ev)) {
+        if (ev.type == KEYPAD_EVENT_PRESS) {
+            return ev.key;            // otpuštanja preskačemo
+        }
+    }
+
+    // Ako nijedna tipka nije pritisnuta → vrati 0
+    return 0;
+}
+
+// - Broj događaja izgubljenih zbog punog reda
+uint32_t Keypad_Dropped(const Keypad *kp) {
+    return kp->q_dropped;
+}
+
+// - Broj pojava uzorka duha (tri ili više tipki u pravokutniku)
+uint32_t Keypad_Ghosts(const Keypad *kp) {
+    return kp->ghost_count;
+}
@@ -1,19 +1,134 @@
-#ifndef __KEYPAD_H__       // Ako __KEYPAD_H__ nije već definiran...
-#define __KEYPAD_H__       // ...definiraj ga (štiti od višestrukog uključivanja)
-
-// Potrebno zbog tipova i funkcija kao što su GPIO_TypeDef, HAL_GPIO_ReadPin, HAL_GPIO_WritePin itd.
-#include "stm32f4xx_hal.h"
-
-// Prototipovi funkcija za tipkovnicu 4x4 
-//
-// Keypad_Init()
-// - Inicijalizira GPIO pinove za tipkovnicu (postavlja redove kao izlaz, stupce kao ulaz s pull-up)
-//
-// Keypad_GetKey()
-// - Provjerava je li neka tipka pritisnuta
-// - Ako je,vraća char ('0'–'9', 'A'–'D', '*' ili '#')
-// - Ako nije pritisnuto ništa, vraća 0 (null karakter)
-void Keypad_Init(void);
-char Keypad_GetKey(void);
-
-#endif // __KEYPAD_H__   // završetak zaštite od višestrukog uključivanja
+#ifndef __KEYPAD_H__       // Ako __KEYPAD_H__ nije već definiran...
+#define __KEYPAD_H__       // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog tipova i funkcija kao što su GPIO_TypeDef, HAL_GPIO_ReadPin, HAL_GPIO_WritePin itd.
+#include "stm32f4xx_hal.h"
+
+// Raspored tipkovnice (3x4, 4x4 ili 4x5), pinovi i znakovi tipki
+#include "keypad_layout.h"
+
+// --- Postavke skeniranja ---
+// Keypad_ScanTick() se poziva svake 1 ms i u svakom pozivu očita cijelu matricu.
+// Svaka tipka ima svoj debounce brojač od KEYPAD_DEBOUNCE_BITS bitova: nova vrijednost
+// se prihvati tek kad traje 2^KEYPAD_DEBOUNCE_BITS skeniranja zaredom (2^4 × 1 ms = 16 ms).
+#define KEYPAD_DEBOUNCE_BITS   4
+
+// Koliko dugo (ms) treba držati dvije tipke akorda da bi se poslao KEYPAD_EVENT_CHORD
+#define KEYPAD_CHORD_HOLD_MS   1000
+
+// Broj NOP-ova između aktiviranja reda i čitanja kolona (vrijeme smirivanja linija)
+#ifndef KEYPAD_SETTLE_NOPS
+#define KEYPAD_SETTLE_NOPS     8
+#endif
+
+// Broj događaja koji stanu u red (mora biti potencija broja 2)
+#define KEYPAD_QUEUE_SIZE      16
+
+// Vrste događaja
+#define KEYPAD_EVENT_PRESS     1   // tipka je pritisnuta
+#define KEYPAD_EVENT_RELEASE   2   // tipka je otpuštena
+#define KEYPAD_EVENT_CHORD     3   // akord je držan dovoljno dugo (key = KEYPAD_CHORD_*)
+
+// Jedan događaj s tipkovnice
+typedef struct {
+    uint32_t tick;   // HAL_GetTick() u trenutku kad je promjena potvrđena (debounce gotov)
+    char key;        // znak tipke iz KEYPAD_KEYMAP (npr. '0'–'9', 'A'–'D', '*' ili '#')
+    uint8_t type;    // KEYPAD_EVENT_PRESS, KEYPAD_EVENT_RELEASE ili KEYPAD_EVENT_CHORD
+} KeypadEvent;
+
+// Kod porta kolona za SYSCFG_EXTICR (0 = GPIOA, 1 = GPIOB, 2 = GPIOC …) za zadani raspored
+#ifndef KEYPAD_EXTI_PORT
+#define KEYPAD_EXTI_PORT       0u
+#endif
+
+// --- Spajanje jedne tipkovnice ---
+// Raspored (broj redova i kolona, znakovi, akordi) je isti za sve tipkovnice i dolazi
+// iz keypad_layout.h; svaka tipkovnica ima svoj port, pinove redova i prvu kolonu.
+// Kolone su KEYPAD_COLS susjednih pinova od col_shift, a to su ujedno i EXTI linije
+// za buđenje iz STOP-a, pa se kod više tipkovnica ne smiju preklapati.
+typedef struct {
+    GPIO_TypeDef *port;                 // port redova i kolona
+    uint16_t row_pins[KEYPAD_ROWS];     // pin svakog reda (izlazi)
+    uint8_t col_shift;                  // pin prve kolone (ulazi)
+    uint8_t exti_port;                  // kod porta za SYSCFG_EXTICR
+} KeypadPins;
+
+// Spajanje iz keypad_layout.h (tipkovnica na pločici)
+#define KEYPAD_PIN_ITEM(pin)  (pin),
+#define KEYPAD_PINS_DEFAULT { KEYPAD_PORT, { KEYPAD_ROW_LIST(KEYPAD_PIN_ITEM) }, KEYPAD_COL_SHIFT, KEYPAD_EXTI_PORT }
+
+// --- Stanje jedne tipkovnice (handle) ---
+// Polja su interna; skener ih mijenja iz prekida, glavna petlja čita samo red događaja.
+typedef struct {
+    const KeypadPins *pins;             // spajanje; NULL dok Keypad_Init ne završi (prekid tada ne skenira)
+    uint32_t row_bsrr[KEYPAD_ROWS];     // BSRR za svaki red: svi redovi LOW, samo taj HIGH
+    uint32_t row_all;                   // pinovi svih redova
+    uint32_t col_pins;                  // pinovi kolona na portu
+
+    // Debounce je vertikalni brojač: vc[i] je i-ti bit brojača za sve tipke odjednom
+    KeypadMask vc[KEYPAD_DEBOUNCE_BITS];
+    KeypadMask stable;                  // potvrđeno (debounce-ano) stanje matrice
+    KeypadMask reported;                // tipke čiji je pritisak poslan u red
+    KeypadMask pending;                 // tipke iz akorda: pritisnute, pritisak još nije poslan
+    KeypadMask consumed;                // tipke iskorištene za akord: čekaju otpuštanje
+    KeypadMask chord_mask[KEYPAD_CHORDS]; // bitovi obje tipke svakog akorda (računa Keypad_Init)
+    KeypadMask chord_all;               // sve tipke koje sudjeluju u nekom akordu
+    uint16_t chord_ticks;               // koliko se ms drži trenutni akord
+    uint8_t ghosted;                    // 1 dok je u matrici uzorak duha
+    uint32_t ghost_count;               // broj pojava uzorka duha
+
+    // Red događaja (lock-free, jedan pisac = prekid, jedan čitač = glavna petlja)
+    KeypadEvent queue[KEYPAD_QUEUE_SIZE];
+    volatile uint8_t q_head;            // sljedeće slobodno mjesto (piše samo prekid)
+    volatile uint8_t q_tail;            // sljedeći događaj za čitanje (piše samo glavna petlja)
+    volatile uint32_t q_dropped;        // broj izgubljenih događaja (red je bio pun)
+} Keypad;
+
+// Prototipovi funkcija za tipkovnicu
+// Sve funkcije kao prvi parametar primaju tipkovnicu (npr. &keypad iz main.c).
+//
+// Keypad_Init()
+// - Spaja tipkovnicu na pinove, resetira stanje skenera i red događaja, spušta sve redove
+//
+// Keypad_ScanTick()
+// - Poziva se iz prekida svake 1 ms (HAL_SYSTICK_Callback ili prekid timera)
+// - Očita cijelu matricu preko BSRR/IDR registara, radi debounce i stavlja događaje u red
+// - Više tipki odjednom je dozvoljeno; kad tri tipke čine pravokutnik (uzorak duha),
+//   novi pritisci se zadržavaju dok uzorak ne nestane
+// - Tipke koje čine akord (KEYPAD_CHORD_LIST) šalju pritisak tek pri otpuštanju,
+//   osim ako se drže zajedno KEYPAD_CHORD_HOLD_MS – tada se šalje samo KEYPAD_EVENT_CHORD
+//
+// Keypad_PollEvent()
+// - Ne blokira: ako postoji događaj, kopira ga u *ev i vraća 1, inače vraća 0
+//
+// Keypad_GetKey()
+// - Ne blokira: vraća znak sljedećeg pritiska iz reda (znak iz KEYPAD_KEYMAP)
+// - Događaje otpuštanja preskače; ako nema pritiska, vraća 0 (null karakter)
+//
+// Keypad_Dropped()
+// - Broj događaja izgubljenih jer je red bio pun
+//
+// Keypad_Ghosts()
+// - Broj pojava uzorka duha od pokretanja
+//
+// Keypad_Pending()
+// - 1 ako u redu čeka barem jedan događaj
+//
+// Keypad_Idle()
+// - 1 ako nijedna tipka nije pritisnuta, debounce ništa ne broji i red je prazan
+//
+// Keypad_Park() / Keypad_Resume()
+// - Prije STOP-a: svi redovi HIGH da pritisak bilo koje tipke digne kolonu (EXTI buđenje)
+// - Nakon buđenja: redovi LOW, skeniranje se nastavlja u SysTick prekidu
+void Keypad_Init(Keypad *kp, const KeypadPins *pins);
+void Keypad_ScanTick(Keypad *kp);
+uint8_t Keypad_PollEvent(Keypad *kp, KeypadEvent *ev);
+char Keypad_GetKey(Keypad *kp);
+uint32_t Keypad_Dropped(const Keypad *kp);
+uint32_t Keypad_Ghosts(const Keypad *kp);
+uint8_t Keypad_Pending(const Keypad *kp);
+uint8_t Keypad_Idle(const Keypad *kp);
+void Keypad_Park(Keypad *kp);
+void Keypad_Resume(Keypad *kp);
+
+#endif // __KEYPAD_H__   // završetak zaštite od višestrukog uključivanja
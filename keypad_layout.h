@@ -0,0 +1,105 @@
+#ifndef __KEYPAD_LAYOUT_H__    // Ako __KEYPAD_LAYOUT_H__ nije već definiran...
+#define __KEYPAD_LAYOUT_H__    // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog GPIOA i GPIO_PIN_x
+#include "stm32f4xx_hal.h"
+
+// --- Opis rasporeda tipkovnice (odabire se pri prevođenju) ---
+// Skener u keypad.c se generira iz ovih makroa: broj redova i stupaca su konstante,
+// tablica BSRR vrijednosti za redove se izračuna pri prevođenju, a kolone se čitaju
+// jednim čitanjem IDR registra. Kolone moraju biti uzastopni pinovi istog porta.
+//
+// Raspored se bira s -DKEYPAD_LAYOUT=KEYPAD_LAYOUT_3X4 (ili 4X4, 4X5) ili ovdje.
+
+#define KEYPAD_LAYOUT_3X4  1   // 3 stupca × 4 reda (telefonska tipkovnica)
+#define KEYPAD_LAYOUT_4X4  2   // 4 stupca × 4 reda (standardna membranska)
+#define KEYPAD_LAYOUT_4X5  3   // 4 stupca × 5 redova (20 tipki: F1/F2 i strelice)
+
+#ifndef KEYPAD_LAYOUT
+#define KEYPAD_LAYOUT KEYPAD_LAYOUT_4X4
+#endif
+
+// Kodovi akorda (dvije tipke držane zajedno), šalju se kao KeypadEvent.key
+#define KEYPAD_CHORD_SERVICE 'S'   // servisni izbornik / dijagnostika
+#define KEYPAD_CHORD_DURESS  'X'   // tihi alarm pod prisilom (na zaslonu se ništa ne vidi)
+
+// Za svaki raspored:
+//   KEYPAD_PORT        port na kojem su redovi i kolone
+//   KEYPAD_ROWS        broj redova (izlazi, aktivni HIGH)
+//   KEYPAD_COLS        broj kolona (ulazi, HIGH = tipka pritisnuta u aktivnom redu)
+//   KEYPAD_ROW_LIST(X) pinovi redova redom, X(pin) za svaki red
+//   KEYPAD_ROW_PINS    maska svih redova (isti pinovi kao u KEYPAD_ROW_LIST)
+//   KEYPAD_COL_SHIFT   broj pina prve kolone (kolone su pinovi COL_SHIFT .. COL_SHIFT+COLS-1)
+//   KEYPAD_KEYMAP      znakovi tipki red po red (indeks = red * KEYPAD_COLS + kolona)
+//   KEYPAD_CHORD_LIST(X) akordi, X(tipka1, tipka2, kod) za svaki; tipke iz akorda se
+//                      ne šalju kao obični pritisci dok se ne otpuste bez akorda
+//   KEYPAD_KEY_ENTER   tipka predaje lozinki kraćih od najdulje (tablica korisnika, cred.h);
+//                      0 = raspored je nema, pa sve korisničke lozinke imaju 4 znaka.
+//                      Ne smije biti u akordu (pritisak bi stigao tek kod otpuštanja).
+
+#if KEYPAD_LAYOUT == KEYPAD_LAYOUT_3X4
+// Redovi: PA0, PA1, PA8, PA9 – Kolone: PA4, PA5, PA6
+#define KEYPAD_PORT          GPIOA
+#define KEYPAD_ROWS          4
+#define KEYPAD_COLS          3
+#define KEYPAD_ROW_LIST(X)   X(GPIO_PIN_0) X(GPIO_PIN_1) X(GPIO_PIN_8) X(GPIO_PIN_9)
+#define KEYPAD_ROW_PINS      (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_8 | GPIO_PIN_9)
+#define KEYPAD_COL_SHIFT     4
+#define KEYPAD_KEYMAP        "123" \
+                             "456" \
+                             "789" \
+                             "*0#"
+#define KEYPAD_CHORD_LIST(X) X('*', '#', KEYPAD_CHORD_SERVICE) X('1', '3', KEYPAD_CHORD_DURESS)
+#define KEYPAD_KEY_ENTER     0     // nema slobodne tipke
+
+#elif KEYPAD_LAYOUT == KEYPAD_LAYOUT_4X4
+// Redovi: PA0, PA1, PA8, PA9 – Kolone: PA4, PA5, PA6, PA7
+#define KEYPAD_PORT          GPIOA
+#define KEYPAD_ROWS          4
+#define KEYPAD_COLS          4
+#define KEYPAD_ROW_LIST(X)   X(GPIO_PIN_0) X(GPIO_PIN_1) X(GPIO_PIN_8) X(GPIO_PIN_9)
+#define KEYPAD_ROW_PINS      (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_8 | GPIO_PIN_9)
+#define KEYPAD_COL_SHIFT     4
+#define KEYPAD_KEYMAP        "123A" \
+                             "456B" \
+                             "789C" \
+                             "*0#D"
+#define KEYPAD_CHORD_LIST(X) X('*', '#', KEYPAD_CHORD_SERVICE) X('B', 'C', KEYPAD_CHORD_DURESS)
+#define KEYPAD_KEY_ENTER     'D'
+
+#elif KEYPAD_LAYOUT == KEYPAD_LAYOUT_4X5
+// Redovi: PA0, PA1, PA8, PA9, PA10 – Kolone: PA4, PA5, PA6, PA7
+// F1/F2 → 'F'/'G', strelice gore/dolje/lijevo/desno → 'U'/'N'/'L'/'R', Esc → 'E', Enter → 'K'
+#define KEYPAD_PORT          GPIOA
+#define KEYPAD_ROWS          5
+#define KEYPAD_COLS          4
+#define KEYPAD_ROW_LIST(X)   X(GPIO_PIN_0) X(GPIO_PIN_1) X(GPIO_PIN_8) X(GPIO_PIN_9) X(GPIO_PIN_10)
+#define KEYPAD_ROW_PINS      (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_8 | GPIO_PIN_9 | GPIO_PIN_10)
+#define KEYPAD_COL_SHIFT     4
+#define KEYPAD_KEYMAP        "FG#*" \
+                             "123U" \
+                             "456N" \
+                             "789E" \
+                             "L0RK"
+#define KEYPAD_CHORD_LIST(X) X('F', 'G', KEYPAD_CHORD_SERVICE) X('L', 'R', KEYPAD_CHORD_DURESS)
+#define KEYPAD_KEY_ENTER     'K'   // Enter
+
+#else
+#error "Nepoznat KEYPAD_LAYOUT"
+#endif
+
+// --- Izvedene konstante (sve se izračunaju pri prevođenju) ---
+#define KEYPAD_KEYS          (KEYPAD_ROWS * KEYPAD_COLS)
+#define KEYPAD_COL_MASK      ((1u << KEYPAD_COLS) - 1u)            // kolone nakon pomaka
+#define KEYPAD_CHORD_ONE(a, b, code) + 1
+#define KEYPAD_CHORDS        (0 KEYPAD_CHORD_LIST(KEYPAD_CHORD_ONE))   // broj akorda
+#define KEYPAD_COL_PINS      (KEYPAD_COL_MASK << KEYPAD_COL_SHIFT)  // kolone na portu
+
+// Stanje cijele matrice kao maska bitova: bit (red * KEYPAD_COLS + kolona) = tipka pritisnuta
+#if KEYPAD_KEYS <= 16
+typedef uint16_t KeypadMask;
+#else
+typedef uint32_t KeypadMask;
+#endif
+
+#endif // __KEYPAD_LAYOUT_H__   // završetak zaštite od višestrukog uključivanja
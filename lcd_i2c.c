@@ -1,104 +1,400 @@
-#include "lcd_i2c.h"     // Uključuje header datoteku s deklaracijama funkcija za LCD
-#include "main.h"        // Uključuje HAL definicije i globalne varijable iz CubeMX-a
-#include <string.h>      // Biblioteka za rad sa stringovima (strlen, strcpy...), zgodno za ispis teksta
-
-// --- Staticke varijable za čuvanje stanja LCD-a ---
-static I2C_HandleTypeDef *lcd_i2c; // Pokazivač na I2C handler (definiran u main.c) – HAL ga koristi za komunikaciju
-static uint8_t lcd_addr;           // I2C adresa LCD modula (obično 0x27 ili 0x3F)
-static uint8_t lcd_cols;           // Broj stupaca (npr. 16 ili 20)
-static uint8_t lcd_rows;           // Broj redaka (npr. 2 ili 4)
-
-// --- Definicije kontrolnih bita prema PCF8574 expanderu ---
-#define LCD_BACKLIGHT 0x08   // Bit koji uključuje pozadinsko svjetlo LCD-a
-#define LCD_ENABLE    0x04   // Bit povezan na E pin LCD-a (Enable) – kad je 1, LCD očitava podatke
-#define LCD_COMMAND   0      // RS=0 → označava da šaljemo naredbu (command)
-#define LCD_DATA      1      // RS=1 → označava da šaljemo podatke (tekst, znakove)
-
-// --- Funkcija za slanje naredbi LCD-u ---
-static void lcd_send_cmd(uint8_t cmd) {
-    uint8_t data_u, data_l;  // Gornja i donja polovica bajta (high i low nibble)
-    uint8_t data_t[4];       // Buffer od 4 bajta koji se šalje preko I2C-a
-
-    data_u = (cmd & 0xF0);         // Uzmi gornjih 4 bita naredbe (high nibble)
-    data_l = ((cmd << 4) & 0xF0);  // Pomakni donjih 4 bita u gornji položaj (low nibble → high)
-
-    // Slanje gornjih 4 bita:
-    data_t[0] = data_u | LCD_BACKLIGHT | LCD_ENABLE; // Postavi podatke + pozadinsko svjetlo + E=1
-    data_t[1] = data_u | LCD_BACKLIGHT;              // Spusti E=0 → LCD registrira podatke
-
-    // Slanje donjih 4 bita:
-    data_t[2] = data_l | LCD_BACKLIGHT | LCD_ENABLE; // Postavi donjih 4 bita + E=1
-    data_t[3] = data_l | LCD_BACKLIGHT;              // Spusti E=0 → LCD registrira podatke
-
-    // Pošalji svih 4 faza preko I2C-a
-    HAL_I2C_Master_Transmit(lcd_i2c, lcd_addr << 1, data_t, 4, 100);
-}
-
-// --- Funkcija za slanje podataka (znakova) LCD-u ---
-static void lcd_send_data(uint8_t data) {
-    uint8_t data_u, data_l;  // Gornjih i donjih 4 bita znaka
-    uint8_t data_t[4];       // Buffer od 4 bajta za prijenos
-
-    data_u = (data & 0xF0);        // Uzmi gornjih 4 bita znaka
-    data_l = ((data << 4) & 0xF0); // Pomakni donjih 4 bita u gornji položaj
-
-    // Slanje gornjih 4 bita znaka (RS=1 jer šaljemo podatke, ne naredbe)
-    data_t[0] = data_u | LCD_BACKLIGHT | LCD_ENABLE | LCD_DATA;
-    data_t[1] = data_u | LCD_BACKLIGHT | LCD_DATA;   // E=0 → potvrda
-
-    // Slanje donjih 4 bita znaka
-    data_t[2] = data_l | LCD_BACKLIGHT | LCD_ENABLE | LCD_DATA;
-    data_t[3] = data_l | LCD_BACKLIGHT | LCD_DATA;   // E=0 → potvrda
-
-    // Pošalji sve 4 faze preko I2C-a
-    HAL_I2C_Master_Transmit(lcd_i2c, lcd_addr << 1, data_t, 4, 100);
-}
-
-// --- Funkcija za inicijalizaciju LCD-a ---
-void lcd_i2c_init(I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t cols, uint8_t rows) {
-    lcd_i2c = hi2c;   // Spremi I2C handler
-    lcd_addr = addr;  // Spremi I2C adresu modula
-    lcd_cols = cols;  // Spremi broj stupaca
-    lcd_rows = rows;  // Spremi broj redaka
-    HAL_Delay(50);    // Pričekaj 50 ms da se LCD uključi
-
-    // Inicijalizacijska sekvenca prema datasheetu za HD44780
-    lcd_send_cmd(0x30);  // Force 8-bit mode
-    HAL_Delay(5);        // Pričekaj
-    lcd_send_cmd(0x30);  // Ponovi
-    HAL_Delay(1);        // Kratko čekanje
-    lcd_send_cmd(0x30);  // Još jednom
-    HAL_Delay(10);       // Pričekaj
-    lcd_send_cmd(0x20);  // Sada prebaci u 4-bitni način rada
-    HAL_Delay(10);
-
-    // Standardne postavke nakon prelaska u 4-bit mode
-    lcd_send_cmd(0x28);  // Function set: 4-bit, 2 linije, font 5x8
-    HAL_Delay(1);
-    lcd_send_cmd(0x08);  // Display OFF
-    HAL_Delay(1);
-    lcd_send_cmd(0x01);  // Clear display
-    HAL_Delay(2);
-    lcd_send_cmd(0x06);  // Entry mode: automatski pomak kursora udesno
-    HAL_Delay(1);
-    lcd_send_cmd(0x0C);  // Display ON, cursor OFF
-}
-
-// --- Očisti cijeli LCD ---
-void lcd_i2c_clear(void) {
-    lcd_send_cmd(0x01); // Naredba za brisanje ekrana
-    HAL_Delay(2);       // Brisanje traje duže → čekamo 2 ms
-}
-
-// --- Postavi kursor na određenu poziciju (col, row) ---
-void lcd_i2c_set_cursor(uint8_t col, uint8_t row) {
-    uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54}; // DDRAM adrese početaka redova
-    lcd_send_cmd(0x80 | (col + row_offsets[row]));    // 0x80 = naredba za set DDRAM address
-}
-
-// --- Ispis stringa na LCD ---
-void lcd_i2c_print(char *str) {
-    while (*str) {             // Dok string ne dođe do '\0'
-        lcd_send_data(*str++); // Šaljemo znak po znak i pomičemo pointer
-    }
-}
+#include "lcd_i2c.h"     // Uključuje header datoteku s deklaracijama funkcija za LCD
+#include "main.h"        // Uključuje HAL definicije i globalne varijable iz CubeMX-a
+#include "prof.h"        // Mjerenje trajanja (isključeno ako PROF_ENABLE nije 1)
+#include "timebase.h"    // Mikrosekundna čekanja (TIM5) umjesto HAL_Delay-a
+#include <string.h>      // Biblioteka za rad sa stringovima (strlen, strcpy...), zgodno za ispis teksta
+
+// Stanje svakog LCD-a je u strukturi LcdI2c (lcd_i2c.h), pa driver nema globalnih varijabli
+// i isti kod vodi više zaslona na istoj sabirnici.
+
+// --- Definicije kontrolnih bita prema PCF8574 expanderu ---
+#define LCD_BACKLIGHT 0x08   // Bit koji uključuje pozadinsko svjetlo LCD-a
+#define LCD_ENABLE    0x04   // Bit povezan na E pin LCD-a (Enable) – kad je 1, LCD očitava podatke
+#define LCD_COMMAND   0      // RS=0 → označava da šaljemo naredbu (command)
+#define LCD_DATA      1      // RS=1 → označava da šaljemo podatke (tekst, znakove)
+
+// --- Trajanja naredbi HD44780 (datasheet, fosc = 270 kHz) ---
+// Čeka se od kraja I2C prijenosa, tj. od silaznog brida E zadnjeg nibblea naredbe.
+// Za module sa sporijim oscilatorom vrijednosti se mogu povećati pri prevođenju.
+#ifndef LCD_POWER_ON_US
+#define LCD_POWER_ON_US  40000U   // od uključenja napajanja (VCC 2.7 V) do prve naredbe
+#endif
+#ifndef LCD_INIT1_US
+#define LCD_INIT1_US     4100U    // nakon prvog 0x3 u reset slijedu
+#endif
+#ifndef LCD_INIT2_US
+#define LCD_INIT2_US     100U     // nakon drugog 0x3
+#endif
+#ifndef LCD_EXEC_US
+#define LCD_EXEC_US      37U      // većina naredbi
+#endif
+#ifndef LCD_CLEAR_US
+#define LCD_CLEAR_US     1520U    // clear display / return home
+#endif
+
+// --- Bitmape ikona (5x8, redak po redak, donjih 5 bitova) ---
+static const uint8_t lcd_glyphs[LCD_GLYPH_COUNT][8] = {
+    [LCD_GLYPH_DOT]          = {0x00, 0x00, 0x0E, 0x1F, 0x1F, 0x0E, 0x00, 0x00},
+    [LCD_GLYPH_LOCK]         = {0x0E, 0x11, 0x11, 0x1F, 0x1B, 0x1B, 0x1F, 0x00},
+    [LCD_GLYPH_UNLOCK]       = {0x0E, 0x10, 0x10, 0x1F, 0x1B, 0x1B, 0x1F, 0x00},
+    [LCD_GLYPH_BATTERY_LOW]  = {0x0E, 0x1B, 0x11, 0x11, 0x11, 0x11, 0x1F, 0x00},
+    [LCD_GLYPH_BATTERY_HALF] = {0x0E, 0x1B, 0x11, 0x11, 0x1F, 0x1F, 0x1F, 0x00},
+    [LCD_GLYPH_BATTERY_FULL] = {0x0E, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x00},
+    [LCD_GLYPH_BAR1]         = {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},
+    [LCD_GLYPH_BAR2]         = {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},
+    [LCD_GLYPH_BAR3]         = {0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},
+    [LCD_GLYPH_BAR4]         = {0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},
+};
+
+// Zamjenski ASCII znak kad za ikonu nema slobodnog utora
+static const char lcd_glyph_fallback[LCD_GLYPH_COUNT] = {
+    '*', 'L', 'U', 'b', 'b', 'B', '|', '|', '|', '|',
+};
+
+#define LCD_GLYPH_CODE  0x08  // prvi kod CGRAM znakova koji nije '\0' (0x08–0x0F = utori 0–7)
+#define LCD_CURSOR_NONE 0xFF  // položaj kursora nije poznat (AC pokazuje u CGRAM)
+
+// --- Prijenos preko I2C-a (red sabirnice, dvostruki buffer) ---
+// Sve faze (nibble + enable) jednog stringa ili niza naredbi slažu se u jedan
+// buffer i predaju sabirnici kao JEDAN zahtjev. Sabirnica ih šalje redom (i između
+// više LCD-ova), a CPU za to vrijeme puni drugi buffer.
+
+// --- Završetak prijenosa (poziva ga sabirnica iz prekida) ---
+static void lcd_tx_done(I2cBusReq *req, uint8_t ok) {
+    LcdI2c *lcd = req->ctx;
+    (void)ok;                        // neuspjeli prijenos je izbrojen u bus->errors
+    if (lcd->tx_done_cb) {
+        lcd->tx_done_cb(lcd);        // javi korisniku da je prijenos gotov
+    }
+}
+
+// --- Čekaj da sabirnica pošalje zadani buffer ---
+static void lcd_tx_wait(const I2cBusReq *req) {
+    PROF_BEGIN(LCD_WAIT);
+    while (req->pending) {
+        __WFI();                     // prekid završetka (ili SysTick) budi jezgru
+    }
+    PROF_END(LCD_WAIT);
+}
+
+// --- Buffer koji se puni mora biti slobodan (sabirnica ga je možda još šalje) ---
+static void lcd_tx_claim(LcdI2c *lcd) {
+    if (lcd->tx_len == 0) {
+        lcd_tx_wait(&lcd->tx_req[lcd->tx_fill]);
+    }
+}
+
+// --- Predaj napunjeni buffer sabirnici (ne čeka) ---
+static void lcd_tx_kick(LcdI2c *lcd) {
+    if (lcd->tx_len == 0) return;    // nema ništa za slanje
+
+    I2cBusReq *req = &lcd->tx_req[lcd->tx_fill];
+    req->data = lcd->tx_buf[lcd->tx_fill];
+    req->len = lcd->tx_len;
+    req->addr = lcd->addr;
+    req->done = lcd_tx_done;
+    req->ctx = lcd;
+    I2cBus_Submit(lcd->bus, req);    // ide u red; ako je sabirnica slobodna, kreće odmah
+
+    lcd->tx_fill ^= 1;               // sljedeće punimo drugi buffer
+    lcd->tx_len = 0;
+}
+
+// --- Pošalji sve što je u bufferu i pričekaj kraj prijenosa (za naredbe koje traže čekanje) ---
+static void lcd_tx_sync(LcdI2c *lcd) {
+    lcd_tx_kick(lcd);
+    lcd_tx_wait(&lcd->tx_req[lcd->tx_fill ^ 1]);  // zadnji predani; red je FIFO pa su i raniji gotovi
+}
+
+// --- Dodaj jedan bajt (naredbu ili znak) u buffer kao 4 faze za PCF8574 ---
+static void lcd_queue(LcdI2c *lcd, uint8_t val, uint8_t mode) {
+    uint8_t data_u, data_l;  // Gornja i donja polovica bajta (high i low nibble)
+    uint8_t *data_t;         // Pokazivač na 4 bajta u bufferu
+    PROF_BEGIN(LCD_QUEUE);
+
+    if (lcd->tx_len + 4 > LCD_TX_BUF_SIZE) {
+        lcd_tx_kick(lcd);    // buffer je pun → pošalji ga i nastavi u drugom
+    }
+    lcd_tx_claim(lcd);
+    data_t = &lcd->tx_buf[lcd->tx_fill][lcd->tx_len];
+    lcd->tx_len += 4;
+
+    data_u = (val & 0xF0);         // Uzmi gornjih 4 bita (high nibble)
+    data_l = ((val << 4) & 0xF0);  // Pomakni donjih 4 bita u gornji položaj (low nibble → high)
+
+    // Slanje gornjih 4 bita (RS=mode: 0 naredba, 1 podatak)
+    data_t[0] = data_u | LCD_BACKLIGHT | LCD_ENABLE | mode; // Postavi podatke + pozadinsko svjetlo + E=1
+    data_t[1] = data_u | LCD_BACKLIGHT | mode;              // Spusti E=0 → LCD registrira podatke
+
+    // Slanje donjih 4 bita
+    data_t[2] = data_l | LCD_BACKLIGHT | LCD_ENABLE | mode; // Postavi donjih 4 bita + E=1
+    data_t[3] = data_l | LCD_BACKLIGHT | mode;              // Spusti E=0 → LCD registrira podatke
+    PROF_END(LCD_QUEUE);
+}
+
+// --- Funkcija za slanje naredbi LCD-u (samo dodaje u buffer) ---
+static void lcd_send_cmd(LcdI2c *lcd, uint8_t cmd) {
+    lcd_queue(lcd, cmd, LCD_COMMAND);
+}
+
+// --- Funkcija za slanje podataka (znakova) LCD-u (samo dodaje u buffer) ---
+static void lcd_send_data(LcdI2c *lcd, uint8_t data) {
+    lcd_queue(lcd, data, LCD_DATA);
+}
+
+// --- Naredba koja se šalje odmah i čeka kraj prijenosa (inicijalizacija, clear) ---
+static void lcd_send_cmd_sync(LcdI2c *lcd, uint8_t cmd) {
+    lcd_send_cmd(lcd, cmd);
+    lcd_tx_sync(lcd);
+}
+
+// --- Samo gornji nibble (jedan E impuls) – za reset slijed dok je LCD još u 8-bitnom načinu ---
+// U 8-bitnom načinu svaki E impuls je cijela naredba, pa bi drugi nibble punog bajta
+// (0x0) nakon prelaska na 4 bita postao gornja polovica sljedeće naredbe.
+static void lcd_send_nibble_sync(LcdI2c *lcd, uint8_t nibble) {
+    if (lcd->tx_len + 2 > LCD_TX_BUF_SIZE) {
+        lcd_tx_kick(lcd);
+    }
+    lcd_tx_claim(lcd);
+    lcd->tx_buf[lcd->tx_fill][lcd->tx_len++] = (nibble & 0xF0) | LCD_BACKLIGHT | LCD_ENABLE; // E=1
+    lcd->tx_buf[lcd->tx_fill][lcd->tx_len++] = (nibble & 0xF0) | LCD_BACKLIGHT;              // E=0
+    lcd_tx_sync(lcd);
+}
+
+// --- Dodaj set-cursor naredbu u buffer i zapamti poziciju kursora ---
+static void lcd_queue_cursor(LcdI2c *lcd, uint8_t col, uint8_t row) {
+    static const uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54}; // DDRAM adrese početaka redova
+    lcd_send_cmd(lcd, 0x80 | (col + row_offsets[row]));            // 0x80 = naredba za set DDRAM address
+    lcd->cur_col = col;                                            // Zapamti gdje je sada kursor
+    lcd->cur_row = row;
+}
+
+// --- Pomoćna funkcija: popuni oba buffera razmacima (stanje nakon naredbe 0x01) ---
+static void lcd_fb_reset(LcdI2c *lcd) {
+    memset(lcd->fb, ' ', sizeof(lcd->fb));         // željeni sadržaj = prazan zaslon
+    memset(lcd->shadow, ' ', sizeof(lcd->shadow)); // DDRAM nakon brisanja = razmaci
+    lcd->cur_col = 0;                              // Clear vraća kursor na (0,0)
+    lcd->cur_row = 0;
+}
+
+// --- Pomoćna funkcija: je li znak 'ch' u framebufferu ili u DDRAM-u (shadow) ---
+// Znak koji je još samo u DDRAM-u je na zaslonu do sljedećeg flusha: nova bitmapa
+// u njegovom utoru bi se odmah pokazala na tom mjestu.
+static uint8_t lcd_char_in_use(const LcdI2c *lcd, char ch) {
+    for (uint8_t row = 0; row < lcd->rows; row++) {
+        if (memchr(lcd->fb[row], ch, lcd->cols) || memchr(lcd->shadow[row], ch, lcd->cols)) return 1;
+    }
+    return 0;
+}
+
+// --- Zajednički dio hladne i tople inicijalizacije ---
+// Hladno (nakon uključenja): 40 ms od uključenja napajanja, pa reset slijed s
+// 0x3 / 4,1 ms / 0x3 / 100 µs / 0x3, kako ga traži datasheet.
+// Toplo (reset procesora, LCD je ostao uključen u 4-bitnom načinu): čekanje
+// uključenja i reset slijed otpadaju, ali reset je mogao prekinuti slanje
+// bajta na pola. Zato se LCD ponovno sinkronizira s tri 0x3 i jednim 0x2:
+// prvi 0x3 je ili gornja polovica (ništa se ne izvršava) ili dovršava
+// prekinuti bajt (najgore "return home", 1,52 ms); sljedeća dva čine 0x33
+// (8-bitni način) ili su već dvije 8-bitne naredbe, a 0x2 vraća 4-bitni način.
+static void lcd_setup(LcdI2c *lcd, I2cBus *bus, uint8_t addr, uint8_t cols, uint8_t rows, uint8_t warm) {
+    lcd_tx_wait(&lcd->tx_req[0]);  // Ako je prijenos još u tijeku (ponovna inicijalizacija), pričekaj ga
+    lcd_tx_wait(&lcd->tx_req[1]);
+    lcd->bus = bus;                // Spremi sabirnicu
+    lcd->addr = addr;              // Spremi I2C adresu modula
+    lcd->cols = (cols > LCD_MAX_COLS) ? LCD_MAX_COLS : cols;  // Spremi broj stupaca (najviše LCD_MAX_COLS)
+    lcd->rows = (rows > LCD_MAX_ROWS) ? LCD_MAX_ROWS : rows;  // Spremi broj redaka (najviše LCD_MAX_ROWS)
+    lcd->tx_fill = 0;
+    lcd->tx_len = 0;
+    memset(lcd->cg_glyph, LCD_GLYPH_NONE, sizeof(lcd->cg_glyph)); // sadržaj CGRAM-a nije poznat
+    memset(lcd->cg_used, 0, sizeof(lcd->cg_used));
+    lcd->frame = 0;
+    lcd->cg_loads = 0;
+
+    if (!warm) {
+        // LCD se uključio zajedno s procesorom: do 40 ms nedostaje samo ono što još
+        // nije prošlo od reseta (SysTick broji od HAL_Init-a, pa je ovo donja granica)
+        uint32_t up_us = HAL_GetTick() * 1000U;
+        if (up_us < LCD_POWER_ON_US) Timebase_Delay(LCD_POWER_ON_US - up_us);
+    }
+
+    // Reset slijed (hladno) ili ponovna sinkronizacija nibblea (toplo)
+    lcd_send_nibble_sync(lcd, 0x30); // Force 8-bit mode
+    Timebase_Delay(warm ? LCD_CLEAR_US : LCD_INIT1_US);
+    lcd_send_nibble_sync(lcd, 0x30); // Ponovi
+    Timebase_Delay(warm ? LCD_EXEC_US : LCD_INIT2_US);
+    lcd_send_nibble_sync(lcd, 0x30); // Još jednom
+    Timebase_Delay(LCD_EXEC_US);
+    lcd_send_nibble_sync(lcd, 0x20); // Sada prebaci u 4-bitni način rada (samo jedan nibble)
+    Timebase_Delay(LCD_EXEC_US);
+
+    // Standardne postavke nakon prelaska u 4-bit mode
+    lcd_send_cmd_sync(lcd, 0x28); // Function set: 4-bit, 2 linije, font 5x8
+    Timebase_Delay(LCD_EXEC_US);
+    lcd_send_cmd_sync(lcd, 0x08); // Display OFF
+    Timebase_Delay(LCD_EXEC_US);
+    lcd_send_cmd_sync(lcd, 0x01); // Clear display
+    Timebase_Delay(LCD_CLEAR_US);
+    lcd_send_cmd_sync(lcd, 0x06); // Entry mode: automatski pomak kursora udesno
+    Timebase_Delay(LCD_EXEC_US);
+    lcd_send_cmd_sync(lcd, 0x0C); // Display ON, cursor OFF
+    Timebase_Delay(LCD_EXEC_US);
+
+    lcd_fb_reset(lcd);       // Zaslon je prazan → framebuffer i kopija DDRAM-a su razmaci
+}
+
+// --- Funkcija za inicijalizaciju LCD-a ---
+void lcd_i2c_init(LcdI2c *lcd, I2cBus *bus, uint8_t addr, uint8_t cols, uint8_t rows) {
+    lcd_setup(lcd, bus, addr, cols, rows, 0);
+}
+
+// --- Inicijalizacija LCD-a koji je već bio inicijaliziran (reset bez nestanka napajanja) ---
+void lcd_i2c_init_warm(LcdI2c *lcd, I2cBus *bus, uint8_t addr, uint8_t cols, uint8_t rows) {
+    lcd_setup(lcd, bus, addr, cols, rows, 1);
+}
+
+// --- Očisti cijeli LCD ---
+void lcd_i2c_clear(LcdI2c *lcd) {
+    lcd_send_cmd_sync(lcd, 0x01); // Naredba za brisanje ekrana (čekamo kraj prijenosa)
+    Timebase_Delay(LCD_CLEAR_US); // Brisanje traje duže od ostalih naredbi (1,52 ms)
+    lcd_fb_reset(lcd);       // Uskladi framebuffer s obrisanim zaslonom
+}
+
+// --- Postavi kursor na određenu poziciju (col, row) ---
+void lcd_i2c_set_cursor(LcdI2c *lcd, uint8_t col, uint8_t row) {
+    lcd_queue_cursor(lcd, col, row); // naredba u buffer
+    lcd_tx_kick(lcd);                // pošalji je (ne čekamo kraj prijenosa)
+}
+
+// --- Ispis stringa na LCD ---
+// Cijeli string ide na LCD jednim prijenosom. Znakovi se upisuju i u oba buffera
+// da flush ne bi kasnije "popravljao" ono što je već ispravno prikazano.
+void lcd_i2c_print(LcdI2c *lcd, char *str) {
+    while (*str) {                  // Dok string ne dođe do '\0'
+        if (lcd->cur_row < lcd->rows && lcd->cur_col < lcd->cols) {
+            lcd->fb[lcd->cur_row][lcd->cur_col] = *str;     // željeni sadržaj
+            lcd->shadow[lcd->cur_row][lcd->cur_col] = *str; // stvarni sadržaj DDRAM-a
+        }
+        lcd_send_data(lcd, *str++); // Znak u buffer, pomičemo pointer
+        lcd->cur_col++;             // LCD automatski pomiče kursor udesno (entry mode 0x06)
+    }
+    lcd_tx_kick(lcd);               // cijeli string ide jednim prijenosom
+}
+
+// --- Framebuffer: obriši željeni sadržaj (ništa se ne šalje na LCD) ---
+void lcd_i2c_fb_clear(LcdI2c *lcd) {
+    memset(lcd->fb, ' ', sizeof(lcd->fb));
+}
+
+// --- Framebuffer: upiši string od pozicije (col, row), višak se odsijeca ---
+void lcd_i2c_fb_print(LcdI2c *lcd, uint8_t col, uint8_t row, const char *str) {
+    if (row >= lcd->rows) return;                // red ne postoji na ovom LCD-u
+    while (*str && col < lcd->cols) {
+        lcd->fb[row][col++] = *str++;
+    }
+}
+
+// --- Framebuffer: cijeli red = string + razmaci do kraja reda ---
+void lcd_i2c_fb_line(LcdI2c *lcd, uint8_t row, const char *str) {
+    if (row >= lcd->rows) return;
+    for (uint8_t col = 0; col < lcd->cols; col++) {
+        lcd->fb[row][col] = *str ? *str++ : ' ';  // nakon kraja stringa punimo razmacima
+    }
+}
+
+// --- Framebuffer: pošalji na LCD samo promijenjene ćelije ---
+// Set-cursor naredba se šalje samo kad hardverski kursor nije već na ćeliji
+// koju treba upisati. Ako je između dvije promjene samo jedna nepromijenjena
+// ćelija, ponovno je upišemo (4 bajta, kao i set-cursor) i tako štedimo naredbu.
+void lcd_i2c_flush(LcdI2c *lcd) {
+    PROF_BEGIN(LCD_FLUSH);
+    for (uint8_t row = 0; row < lcd->rows; row++) {
+        for (uint8_t col = 0; col < lcd->cols; col++) {
+            if (lcd->fb[row][col] == lcd->shadow[row][col]) continue; // ćelija je već ispravna
+
+            if (lcd->cur_row == row && lcd->cur_col + 1 == col) {
+                lcd_send_data(lcd, lcd->shadow[row][col - 1]);  // premosti jednu nepromijenjenu ćeliju
+                lcd->cur_col++;
+            } else if (lcd->cur_row != row || lcd->cur_col != col) {
+                lcd_queue_cursor(lcd, col, row);                // skok na ćeliju koja se mijenja
+            }
+
+            lcd_send_data(lcd, lcd->fb[row][col]);              // upiši novi znak
+            lcd->shadow[row][col] = lcd->fb[row][col];          // DDRAM sada sadrži taj znak
+            lcd->cur_col++;                                     // kursor se sam pomaknuo udesno
+        }
+    }
+    lcd_tx_kick(lcd);                                           // sve razlike idu jednim prijenosom
+    lcd->frame++;                                               // ikone tražene od sada su "nove"
+    PROF_END(LCD_FLUSH);
+}
+
+// --- Ikone: znak za ikonu, bitmapa se šalje samo ako ikona nije u CGRAM-u ---
+char lcd_i2c_glyph(LcdI2c *lcd, uint8_t glyph) {
+    if (glyph >= LCD_GLYPH_COUNT) return ' ';
+
+    int8_t slot = -1;
+    uint16_t oldest = 0;
+    for (uint8_t i = 0; i < LCD_CGRAM_SLOTS; i++) {
+        if (lcd->cg_glyph[i] == glyph) {                        // već je u CGRAM-u
+            lcd->cg_used[i] = lcd->frame;
+            return (char)(LCD_GLYPH_CODE + i);
+        }
+    }
+    // Prazan utor ili najdavnije tražena ikona koje nema ni u fb ni na zaslonu
+    for (uint8_t i = 0; i < LCD_CGRAM_SLOTS; i++) {
+        if (lcd->cg_glyph[i] == LCD_GLYPH_NONE) {
+            slot = (int8_t)i;
+            break;
+        }
+        uint16_t age = (uint16_t)(lcd->frame - lcd->cg_used[i]);
+        if ((slot < 0 || age > oldest) && !lcd_char_in_use(lcd, (char)(LCD_GLYPH_CODE + i))) {
+            slot = (int8_t)i;
+            oldest = age;
+        }
+    }
+    if (slot < 0) return lcd_glyph_fallback[glyph];             // svih 8 ikona je u upotrebi
+
+    // Bitmapa u CGRAM (naredba 0x40 | adresa, pa 8 redaka), zatim kursor natrag u DDRAM
+    lcd_send_cmd(lcd, 0x40 | (uint8_t)(slot << 3));
+    for (uint8_t r = 0; r < 8; r++) {
+        lcd_send_data(lcd, lcd_glyphs[glyph][r]);
+    }
+    if (lcd->cur_row < lcd->rows && lcd->cur_col < lcd->cols) {
+        lcd_queue_cursor(lcd, lcd->cur_col, lcd->cur_row);
+    } else {
+        lcd->cur_row = LCD_CURSOR_NONE;                         // flush će postaviti kursor
+    }
+    lcd->cg_glyph[slot] = glyph;
+    lcd->cg_used[slot] = lcd->frame;
+    lcd->cg_loads++;
+    return (char)(LCD_GLYPH_CODE + slot);
+}
+
+// --- Framebuffer: ikona na poziciji (col, row) ---
+void lcd_i2c_fb_glyph(LcdI2c *lcd, uint8_t col, uint8_t row, uint8_t glyph) {
+    if (row >= lcd->rows || col >= lcd->cols) return;
+    lcd->fb[row][col] = lcd_i2c_glyph(lcd, glyph);
+}
+
+// --- Framebuffer: traka napretka (5 koraka po ćeliji) ---
+void lcd_i2c_fb_bar(LcdI2c *lcd, uint8_t col, uint8_t row, uint8_t width, uint32_t value, uint32_t max) {
+    if (row >= lcd->rows || max == 0) return;
+    if (value > max) value = max;
+    uint32_t steps = (uint32_t)(((uint64_t)value * width * 5U + max / 2U) / max);  // popunjeni stupci
+    for (uint8_t i = 0; i < width && col < lcd->cols; i++, col++) {
+        uint32_t n = (steps > 5U) ? 5U : steps;
+        steps -= n;
+        lcd->fb[row][col] = (n == 5U) ? (char)0xFF :
+                            (n == 0U) ? ' ' : lcd_i2c_glyph(lcd, (uint8_t)(LCD_GLYPH_BAR1 + n - 1U));
+    }
+}
+
+// --- Ima li ovaj LCD prijenos u redu ili u tijeku? ---
+uint8_t lcd_i2c_busy(const LcdI2c *lcd) {
+    return lcd->tx_req[0].pending || lcd->tx_req[1].pending;
+}
+
+// --- Postavi callback koji se poziva kad prijenos završi ---
+void lcd_i2c_set_tx_callback(LcdI2c *lcd, void (*cb)(LcdI2c *lcd)) {
+    lcd->tx_done_cb = cb;
+}
@@ -1,32 +1,152 @@
-#ifndef __LCD_I2C_H__       // Ako __LCD_I2C_H__ nije definiran...
-#define __LCD_I2C_H__       // ...definiraj ga (sprječava višestruko uključivanje ovog headera)
-
-// Uključuje osnovne definicije za STM32F4 i HAL biblioteku.
-// Potrebno da bi koristili I2C tipove i funkcije (npr. I2C_HandleTypeDef).
-#include "stm32f4xx_hal.h"  
-
-// --- Prototipovi funkcija za rad s LCD-om preko I2C-a ---
-
-// Inicijalizacija LCD-a preko I2C-a
-// Parametri:
-//   hi2c  → pokazivač na I2C handler (npr. &hi2c1 iz CubeMX-a)
-//   addr  → I2C adresa LCD modula (najčešće 0x27 ili 0x3F)
-//   cols  → broj stupaca LCD-a (npr. 16 ili 20)
-//   rows  → broj redova LCD-a (npr. 2 ili 4)
-void lcd_i2c_init(I2C_HandleTypeDef *hi2c, uint8_t addr, uint8_t cols, uint8_t rows);
-
-// Briše cijeli zaslon LCD-a i vraća kursor na početnu poziciju (0,0).
-void lcd_i2c_clear(void);
-
-// Postavlja kursor na određeni položaj na LCD-u.
-// Parametri:
-//   col → stupac (0–15 kod 16x2 LCD-a)
-//   row → red (0–1 kod 16x2 LCD-a, ili 0–3 kod 20x4 LCD-a)
-void lcd_i2c_set_cursor(uint8_t col, uint8_t row);
-
-// Ispisuje string (niz znakova) na LCD-u počevši od trenutne pozicije kursora.
-// Parametar:
-//   str → pointer na char niz (klasični C string)
-void lcd_i2c_print(char *str);
-
-#endif  // završetak zaštite od višestrukog uključivanja
+#ifndef __LCD_I2C_H__       // Ako __LCD_I2C_H__ nije definiran...
+#define __LCD_I2C_H__       // ...definiraj ga (sprječava višestruko uključivanje ovog headera)
+
+// Uključuje osnovne definicije za STM32F4 i HAL biblioteku.
+// Potrebno da bi koristili I2C tipove i funkcije (npr. I2C_HandleTypeDef).
+#include "stm32f4xx_hal.h"  
+
+// Zajednička I2C sabirnica s redom prijenosa (više LCD-ova na istoj I2C periferiji)
+#include "i2c_bus.h"
+
+// Najveće podržane dimenzije LCD-a (određuju veličinu framebuffera u RAM-u)
+#define LCD_MAX_COLS 20
+#define LCD_MAX_ROWS 4
+
+// Veličina jednog buffera za I2C prijenos (driver koristi dva takva buffera po LCD-u).
+// Svaki znak ili naredba zauzima 4 bajta (2 nibble-a × E=1/E=0).
+#ifndef LCD_TX_BUF_SIZE
+#define LCD_TX_BUF_SIZE 256
+#endif
+
+// --- Ikone u CGRAM-u ---
+// HD44780 ima 8 korisničkih znakova (CGRAM, kodovi 0x00–0x07, isti su i na 0x08–0x0F).
+// Driver ih vodi kao LRU cache: pozivatelj traži ikonu po ID-u, a bitmapa se šalje
+// preko I2C-a samo ako ikona već nije u CGRAM-u. Ćelija s ikonom je u framebufferu
+// obični znak 0x08 + utor, pa je ponovno iscrtavanje iste ikone jedan bajt podatka.
+typedef enum {
+    LCD_GLYPH_DOT = 0,          // točka za maskirani unos lozinke
+    LCD_GLYPH_LOCK,             // zaključan lokot
+    LCD_GLYPH_UNLOCK,           // otključan lokot
+    LCD_GLYPH_BATTERY_LOW,      // baterija: prazna
+    LCD_GLYPH_BATTERY_HALF,     // baterija: pola
+    LCD_GLYPH_BATTERY_FULL,     // baterija: puna
+    LCD_GLYPH_BAR1,             // traka napretka: 1–4 od 5 stupaca ćelije (puna ćelija je 0xFF iz ROM-a)
+    LCD_GLYPH_BAR2,
+    LCD_GLYPH_BAR3,
+    LCD_GLYPH_BAR4,
+    LCD_GLYPH_COUNT
+} LcdGlyph;
+
+#define LCD_CGRAM_SLOTS 8
+#define LCD_GLYPH_NONE  0xFF    // utor CGRAM-a je prazan
+
+// --- Stanje jednog LCD-a (handle) ---
+// Svaki LCD ima svoju strukturu, pa jedan MCU može voditi više zaslona na istoj
+// I2C sabirnici (različite adrese PCF8574, npr. 0x27 i 0x3F). Prijenosi svih
+// zaslona idu kroz zajednički red sabirnice (i2c_bus.h). Polja su interna.
+typedef struct LcdI2c {
+    I2cBus *bus;                               // sabirnica na kojoj je LCD
+    uint8_t addr;                              // I2C adresa LCD modula (obično 0x27 ili 0x3F)
+    uint8_t cols;                              // broj stupaca (npr. 16 ili 20)
+    uint8_t rows;                              // broj redaka (npr. 2 ili 4)
+
+    // Framebuffer u RAM-u (kopija sadržaja DDRAM-a)
+    // fb     → ono što želimo prikazati (pišu ga lcd_i2c_fb_* funkcije)
+    // shadow → ono što je stvarno upisano u DDRAM LCD-a
+    char fb[LCD_MAX_ROWS][LCD_MAX_COLS];
+    char shadow[LCD_MAX_ROWS][LCD_MAX_COLS];
+    uint8_t cur_col;                           // stupac na kojem je hardverski kursor LCD-a
+    uint8_t cur_row;                           // red na kojem je hardverski kursor LCD-a
+
+    // Dvostruki buffer: jedan je predan sabirnici, drugi se puni
+    uint8_t tx_buf[2][LCD_TX_BUF_SIZE];
+    I2cBusReq tx_req[2];                       // zahtjev sabirnici za svaki buffer
+    uint8_t tx_fill;                           // indeks buffera koji se trenutno puni (0 ili 1)
+    uint16_t tx_len;                           // broj bajtova u bufferu koji se puni
+    void (*tx_done_cb)(struct LcdI2c *lcd);    // korisnički callback nakon završenog prijenosa
+
+    // CGRAM cache: koja je ikona u kojem utoru i kad je zadnji put tražena
+    uint8_t cg_glyph[LCD_CGRAM_SLOTS];         // LcdGlyph ili LCD_GLYPH_NONE
+    uint16_t cg_used[LCD_CGRAM_SLOTS];         // broj flush-a u kojem je ikona zadnji put tražena
+    uint16_t frame;                            // broj flush-eva (starost za LRU)
+    uint16_t cg_loads;                         // koliko je bitmapa poslano u CGRAM
+} LcdI2c;
+
+// --- Prototipovi funkcija za rad s LCD-om preko I2C-a ---
+// Sve funkcije kao prvi parametar primaju LCD (npr. &lcd iz main.c).
+
+// Inicijalizacija LCD-a preko I2C-a
+// Parametri:
+//   lcd   → struktura stanja ovog LCD-a
+//   bus   → zajednička I2C sabirnica (I2cBus_Init nad npr. &hi2c1 iz CubeMX-a)
+//   addr  → I2C adresa LCD modula (najčešće 0x27 ili 0x3F)
+//   cols  → broj stupaca LCD-a (npr. 16 ili 20)
+//   rows  → broj redova LCD-a (npr. 2 ili 4)
+// Čekanja su prema datasheetu i mjere se TIM5 brojilom (Timebase_Init mora biti
+// pozvan prije); od uključenja napajanja do praznog zaslona prođe ~45 ms.
+void lcd_i2c_init(LcdI2c *lcd, I2cBus *bus, uint8_t addr, uint8_t cols, uint8_t rows);
+
+// Isto, nakon reseta procesora bez nestanka napajanja (watchdog, NRST, softverski):
+// LCD je već u 4-bitnom načinu, pa se preskaču čekanje uključenja i 8-bitni reset
+// slijed; ostaje kratka ponovna sinkronizacija (~4 ms do praznog zaslona).
+// Parametri su isti kao kod lcd_i2c_init.
+void lcd_i2c_init_warm(LcdI2c *lcd, I2cBus *bus, uint8_t addr, uint8_t cols, uint8_t rows);
+
+// Briše cijeli zaslon LCD-a i vraća kursor na početnu poziciju (0,0).
+void lcd_i2c_clear(LcdI2c *lcd);
+
+// Postavlja kursor na određeni položaj na LCD-u.
+// Parametri:
+//   col → stupac (0–15 kod 16x2 LCD-a)
+//   row → red (0–1 kod 16x2 LCD-a, ili 0–3 kod 20x4 LCD-a)
+void lcd_i2c_set_cursor(LcdI2c *lcd, uint8_t col, uint8_t row);
+
+// Ispisuje string (niz znakova) na LCD-u počevši od trenutne pozicije kursora.
+// Parametar:
+//   str → pointer na char niz (klasični C string)
+void lcd_i2c_print(LcdI2c *lcd, char *str);
+
+// --- Framebuffer (RAM kopija zaslona) ---
+// lcd_i2c_fb_* funkcije mijenjaju samo sadržaj u RAM-u, ništa ne šalju preko I2C-a.
+// lcd_i2c_flush() zatim šalje samo ćelije koje se razlikuju od onoga što je već na LCD-u,
+// s najmanjim mogućim brojem set-cursor naredbi. Nema brisanja zaslona ni HAL_Delay-a.
+
+// Postavlja cijeli framebuffer na razmake (zaslon se obriše tek kod flush-a).
+void lcd_i2c_fb_clear(LcdI2c *lcd);
+
+// Upisuje string u framebuffer od pozicije (col, row); dio koji ne stane u red se odsijeca.
+void lcd_i2c_fb_print(LcdI2c *lcd, uint8_t col, uint8_t row, const char *str);
+
+// Upisuje string u red 'row' i ostatak reda popunjava razmacima.
+void lcd_i2c_fb_line(LcdI2c *lcd, uint8_t row, const char *str);
+
+// Šalje na LCD samo promijenjene ćelije framebuffera.
+void lcd_i2c_flush(LcdI2c *lcd);
+
+// --- Ikone (CGRAM cache) ---
+
+// Vraća znak za ikonu 'glyph' (stavlja se u framebuffer kao i svaki drugi znak).
+// Ako ikona nije u CGRAM-u, bitmapa ide u buffer za slanje (9 znakova) i zamjenjuje
+// najdavnije traženu ikonu koje nema ni u framebufferu ni na zaslonu (shadow, do
+// flusha). Ako je svih 8 utora u upotrebi, vraća se zamjenski ASCII znak.
+char lcd_i2c_glyph(LcdI2c *lcd, uint8_t glyph);
+
+// Upisuje ikonu u framebuffer na poziciju (col, row).
+void lcd_i2c_fb_glyph(LcdI2c *lcd, uint8_t col, uint8_t row, uint8_t glyph);
+
+// Traka napretka širine 'width' ćelija od (col, row), popunjena value/max
+// (5 koraka po ćeliji: pune ćelije su 0xFF, djelomična ćelija je ikona BAR1–BAR4).
+void lcd_i2c_fb_bar(LcdI2c *lcd, uint8_t col, uint8_t row, uint8_t width, uint32_t value, uint32_t max);
+
+// --- Asinkroni prijenos ---
+// lcd_i2c_print(), lcd_i2c_set_cursor() i lcd_i2c_flush() slažu sve bajtove u jedan buffer
+// i predaju ga redu sabirnice, pa se odmah vraćaju. CPU je slobodan dok sabirnica radi;
+// čeka se samo kad treba puniti buffer koji sabirnica još nije poslala.
+
+// Vraća 1 dok ovaj LCD ima prijenos u redu ili u tijeku, 0 kad je sve poslano.
+uint8_t lcd_i2c_busy(const LcdI2c *lcd);
+
+// Postavlja funkciju koja se poziva (iz prekida) kad prijenos završi. NULL = bez callbacka.
+void lcd_i2c_set_tx_callback(LcdI2c *lcd, void (*cb)(LcdI2c *lcd));
+
+#endif  // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,180 @@
+#include "lock_fsm.h"   // Deklaracije automata stanja brave
+
+// Funkcija prijelaza: mijenja stanje i vraća masku akcija
+typedef uint16_t (*LockHandler)(LockFsm *f, char key);
+
+// --- Pomoćne funkcije ---
+
+// Isprazni unos
+static void lock_clear_input(LockFsm *f) {
+    f->idx = 0;
+    f->input[0] = '\0';
+}
+
+// Usporedba lozinke koja uvijek traje jednako (ne otkriva koliko je znakova pogođeno)
+static uint8_t lock_pin_match(const LockFsm *f) {
+    uint8_t diff = (uint8_t)(f->idx ^ LOCK_PIN_LEN);
+    for (int i = 0; i < LOCK_PIN_LEN; i++) {
+        diff |= (uint8_t)(f->input[i] ^ f->pin[i]);
+    }
+    return diff == 0;
+}
+
+// Provjera unosa: glavna lozinka i dodatna provjera se pozivaju uvijek obje,
+// pa trajanje ne otkriva koja je (ako ijedna) prihvatila unos.
+// Vraća 0 (odbijeno), 1 (dodatna provjera) ili 3 (glavna lozinka, bit 1 = smije '#')
+static uint8_t lock_verify(const LockFsm *f) {
+    uint8_t master = lock_pin_match(f);
+    uint8_t ok = master;
+    if (f->verify) ok |= (f->verify(f->input, f->idx) != 0);
+    return (uint8_t)(ok | (master << 1));
+}
+
+// Dodaj znak u unos, vraća 1 kad je unos pun
+static uint8_t lock_append(LockFsm *f, char key, uint8_t len) {
+    f->input[f->idx++] = key;
+    f->input[f->idx] = '\0';
+    return f->idx >= len;
+}
+
+// --- Funkcije prijelaza ---
+
+// Događaj se u ovom stanju ignorira
+static uint16_t on_ignore(LockFsm *f, char key) {
+    (void)f;
+    (void)key;
+    return 0;
+}
+
+// '*' ili tipkalo → sve na početak
+static uint16_t on_reset(LockFsm *f, char key) {
+    (void)key;
+    lock_clear_input(f);
+    f->fails = 0;
+    f->state = LOCK_ST_ENTRY;
+    return LOCK_ACT_OUTPUTS_OFF | LOCK_ACT_TIMER_STOP | LOCK_ACT_REDRAW;
+}
+
+// '#' → upis nove lozinke (samo nakon glavne lozinke, vidi on_hash_open)
+static uint16_t on_hash(LockFsm *f, char key) {
+    (void)key;
+    lock_clear_input(f);
+    f->state = LOCK_ST_CHANGE;
+    return LOCK_ACT_TIMER_STOP | LOCK_ACT_REDRAW;
+}
+
+// Predaja unosa: otključaj ili broji grešku
+static uint16_t lock_submit(LockFsm *f) {
+    uint8_t ok = lock_verify(f);
+    if (ok) {                                           // točna lozinka
+        f->master = (uint8_t)(ok >> 1);                 // korisnička lozinka ne smije mijenjati glavnu
+        f->fails = 0;
+        f->state = LOCK_ST_OPEN;
+        return LOCK_ACT_REDRAW | LOCK_ACT_LED_ON | LOCK_ACT_BEEP_OK;
+    }
+
+    f->fails++;                                         // pogrešna lozinka
+    lock_clear_input(f);
+    f->state = LOCK_ST_WRONG;
+    return LOCK_ACT_REDRAW | LOCK_ACT_SIGNAL_ERR | LOCK_ACT_TIMER_START;
+}
+
+// Znak lozinke dok se upisuje
+static uint16_t on_digit_entry(LockFsm *f, char key) {
+    if (!lock_append(f, key, f->submit_len)) return LOCK_ACT_REDRAW;   // samo prikaži novi znak
+    return lock_submit(f);
+}
+
+// Tipka predaje dok se upisuje: kraći unosi od LOCK_PIN_LEN se ne predaju
+static uint16_t on_enter_entry(LockFsm *f, char key) {
+    (void)key;
+    if (f->idx < LOCK_PIN_LEN) return 0;
+    return lock_submit(f);
+}
+
+// Znak nove lozinke (glavna lozinka ima uvijek LOCK_PIN_LEN znakova). Tipka predaje se ne
+// prihvaća: uz tablicu korisnika ona predaje unos i takva se lozinka ne bi dala upisati
+static uint16_t on_digit_change(LockFsm *f, char key) {
+    if (f->enter && key == f->enter) return 0;
+    if (!lock_append(f, key, LOCK_PIN_LEN)) return LOCK_ACT_REDRAW;
+
+    for (int i = 0; i <= LOCK_PIN_LEN; i++) {
+        f->pin[i] = f->input[i];                        // spremi novu lozinku
+    }
+    f->state = LOCK_ST_CHANGED;
+    return LOCK_ACT_PIN_SAVE | LOCK_ACT_REDRAW | LOCK_ACT_BEEP_OK | LOCK_ACT_TIMER_START;
+}
+
+// Znak dok stoji poruka "Pogresna lozinka!" → poruka se prekida i kreće novi unos
+static uint16_t on_digit_wrong(LockFsm *f, char key) {
+    if (f->fails >= LOCK_MAX_FAILS) return 0;           // blokada čeka istek poruke
+    f->state = LOCK_ST_ENTRY;
+    return LOCK_ACT_TIMER_STOP | on_digit_entry(f, key);
+}
+
+// '#' dok je otključano: promjena lozinke samo ako je otključano glavnom lozinkom.
+// Nova lozinka se trajno sprema (LOCK_ACT_PIN_SAVE), pa je bez toga svatko za
+// tipkovnicom mogao trajno preuzeti bravu.
+static uint16_t on_hash_open(LockFsm *f, char key) {
+    if (!f->master) return 0;
+    return on_hash(f, key);
+}
+
+// Istek poruke o grešci → blokada ili ponovni upis
+static uint16_t on_timeout_wrong(LockFsm *f, char key) {
+    (void)key;
+    if (f->fails >= LOCK_MAX_FAILS) {
+        f->state = LOCK_ST_BLOCKED;
+        return LOCK_ACT_REDRAW | LOCK_ACT_SIGNAL_LOCK;
+    }
+    f->state = LOCK_ST_ENTRY;
+    return LOCK_ACT_REDRAW;
+}
+
+// --- Tablica prijelaza [stanje][događaj] ---
+static const LockHandler lock_table[LOCK_ST_COUNT][LOCK_EV_COUNT] = {
+    //                  DIGIT             STAR       HASH           RESET      TIMEOUT           ENTER
+    [LOCK_ST_ENTRY]   = {on_digit_entry,  on_reset,  on_ignore,     on_reset,  on_ignore,        on_enter_entry},
+    [LOCK_ST_CHANGE]  = {on_digit_change, on_reset,  on_hash,       on_reset,  on_ignore,        on_ignore},
+    [LOCK_ST_OPEN]    = {on_ignore,       on_reset,  on_hash_open,  on_reset,  on_ignore,        on_ignore},
+    [LOCK_ST_WRONG]   = {on_digit_wrong,  on_reset,  on_ignore,     on_reset,  on_timeout_wrong, on_ignore},
+    [LOCK_ST_CHANGED] = {on_ignore,       on_reset,  on_ignore,     on_reset,  on_reset,         on_ignore},
+    [LOCK_ST_BLOCKED] = {on_ignore,       on_reset,  on_ignore,     on_reset,  on_ignore,        on_ignore},
+};
+
+// --- Javne funkcije ---
+
+void LockFsm_Init(LockFsm *f, const char *pin) {
+    for (int i = 0; i < LOCK_PIN_LEN; i++) {
+        f->pin[i] = pin[i];
+    }
+    f->pin[LOCK_PIN_LEN] = '\0';
+    lock_clear_input(f);
+    f->fails = 0;
+    f->master = 0;
+    f->state = LOCK_ST_ENTRY;
+    f->submit_len = LOCK_PIN_LEN;
+    f->enter = 0;
+    f->verify = 0;
+}
+
+// - Bez tipke predaje dulje lozinke ne smiju postojati (Cred_Add ih odbija): glavna
+//   lozinka se tada mora sama predati na LOCK_PIN_LEN znakova
+void LockFsm_SetVerify(LockFsm *f, LockVerifyFn verify, uint8_t max_len, char enter) {
+    if (max_len > LOCK_PIN_MAX) max_len = LOCK_PIN_MAX;
+    f->verify = verify;
+    f->enter = enter;
+    f->submit_len = (verify && enter && max_len > LOCK_PIN_LEN) ? max_len : LOCK_PIN_LEN;
+}
+
+uint16_t LockFsm_Event(LockFsm *f, LockEvent ev, char key) {
+    if ((unsigned)f->state >= LOCK_ST_COUNT || (unsigned)ev >= LOCK_EV_COUNT) return 0;
+    return lock_table[f->state][ev](f, key);
+}
+
+uint16_t LockFsm_Key(LockFsm *f, char key) {
+    LockEvent ev = (key == '*') ? LOCK_EV_STAR :
+                   (key == '#') ? LOCK_EV_HASH :
+                   (f->enter && key == f->enter && f->submit_len > LOCK_PIN_LEN) ? LOCK_EV_ENTER : LOCK_EV_DIGIT;
+    return LockFsm_Event(f, ev, key);
+}
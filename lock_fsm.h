@@ -0,0 +1,82 @@
+#ifndef __LOCK_FSM_H__     // Ako __LOCK_FSM_H__ nije već definiran...
+#define __LOCK_FSM_H__     // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// --- Logika brave kao čisti automat stanja ---
+// Nema HAL poziva ni dinamičke memorije: ulaz je događaj (tipka, tipkalo, istek poruke),
+// izlaz je maska akcija koje pozivatelj izvrši (LCD, LED, buzzer, timer).
+// Isti kod se vrti na pločici (main.c) i na računalu (simulator i replay harness).
+
+#include <stdint.h>
+
+#define LOCK_PIN_LEN    4   // duljina glavne lozinke i najkraći unos koji se smije predati
+#define LOCK_PIN_MAX    8   // najdulji unos (korisničke lozinke iz tablice su 4–8 znakova)
+#define LOCK_MAX_FAILS  3   // broj uzastopnih grešaka nakon kojeg se brava blokira
+
+// Stanja brave
+typedef enum {
+    LOCK_ST_ENTRY = 0,      // upis lozinke ("Upisi lozinku:")
+    LOCK_ST_CHANGE,         // upis nove lozinke ("Nova lozinka:")
+    LOCK_ST_OPEN,           // otključano ("Tocna lozinka!"), LED svijetli
+    LOCK_ST_WRONG,          // poruka "Pogresna lozinka!" dok ne istekne timer
+    LOCK_ST_CHANGED,        // poruka "Lozinka promj." dok ne istekne timer
+    LOCK_ST_BLOCKED,        // zaključano nakon LOCK_MAX_FAILS grešaka, pušta samo '*' ili tipkalo
+    LOCK_ST_COUNT
+} LockState;
+
+// Ulazni događaji
+typedef enum {
+    LOCK_EV_DIGIT = 0,      // bilo koja tipka osim '*' i '#' (tipka predaje samo dok je submit_len = LOCK_PIN_LEN)
+    LOCK_EV_STAR,           // '*' → reset
+    LOCK_EV_HASH,           // '#' → promjena lozinke (samo u LOCK_ST_OPEN nakon glavne lozinke)
+    LOCK_EV_RESET,          // hardversko tipkalo PC13
+    LOCK_EV_TIMEOUT,        // istekao je timer poruke (LOCK_ACT_TIMER_START)
+    LOCK_EV_ENTER,          // tipka predaje (f->enter) → predaj unos (lozinke različitih duljina)
+    LOCK_EV_COUNT
+} LockEvent;
+
+// Izlazne akcije (maska bitova, više akcija u jednom koraku)
+#define LOCK_ACT_REDRAW       0x0001  // iscrtaj zaslon za trenutno stanje (flush šalje samo razlike)
+#define LOCK_ACT_OUTPUTS_OFF  0x0002  // zaustavi LED/buzzer uzorke, ugasi oba
+#define LOCK_ACT_LED_ON       0x0004  // LED trajno uključen
+#define LOCK_ACT_BEEP_OK      0x0008  // kratki beep (točno / lozinka promijenjena)
+#define LOCK_ACT_SIGNAL_ERR   0x0010  // LED blink ×2 i buzzer ×2 (pogrešno)
+#define LOCK_ACT_TIMER_START  0x0020  // pokreni timer poruke (trajanje ovisi o stanju)
+#define LOCK_ACT_TIMER_STOP   0x0040  // poništi timer poruke
+#define LOCK_ACT_SIGNAL_LOCK  0x0080  // uzorak zaključavanja (ulazak u blokadu)
+#define LOCK_ACT_PIN_SAVE     0x0100  // nova lozinka je postavljena → spremi je trajno (f->pin)
+
+// Dodatna provjera unosa (npr. tablica korisnika, cred.h): vraća različito od 0 ako
+// unos od 'len' znakova vrijedi. Mora trajati jednako bez obzira na ishod.
+typedef uint8_t (*LockVerifyFn)(const char *input, uint8_t len);
+
+// Cijelo stanje brave u jednoj strukturi
+typedef struct {
+    LockState state;                 // trenutno stanje
+    uint8_t idx;                     // broj upisanih znakova (0–LOCK_PIN_MAX)
+    uint8_t fails;                   // broj uzastopnih pogrešnih unosa
+    uint8_t master;                  // zadnje otključavanje je bilo glavnom lozinkom ('#' smije promjenu)
+    uint8_t submit_len;              // unos se sam predaje na ovoj duljini (kraći tipkom f->enter)
+    char enter;                      // tipka predaje iz rasporeda tipkovnice (0 = raspored je nema)
+    char input[LOCK_PIN_MAX + 1];    // trenutni unos ('\0' na kraju)
+    char pin[LOCK_PIN_LEN + 1];      // glavna lozinka (mijenja se s '#' nakon otključavanja njome)
+    LockVerifyFn verify;             // dodatna provjera (NULL = samo glavna lozinka)
+} LockFsm;
+
+// Prototipovi funkcija
+//
+// LockFsm_Init()  - početno stanje s lozinkom 'pin' (LOCK_PIN_LEN znakova), bez dodatne provjere
+// LockFsm_SetVerify() - uz glavnu lozinku prihvaća i unose koje 'verify' potvrdi;
+//                   max_len je najdulja lozinka koju 'verify' zna (unos te duljine se sam predaje),
+//                   'enter' je tipka predaje kraćih unosa (KEYPAD_KEY_ENTER; 0 = nema je, pa se
+//                   unos uvijek predaje na LOCK_PIN_LEN znakova). Nova glavna lozinka ne smije
+//                   sadržavati tipku predaje; 'verify' smije biti NULL (samo postavlja tipku).
+// LockFsm_Event() - obradi jedan događaj; 'key' je znak tipke za LOCK_EV_DIGIT, inače se ignorira
+// LockFsm_Key()   - pretvori znak tipke u događaj i obradi ga; tipka predaje je LOCK_EV_ENTER samo
+//                   kad je submit_len veći od LOCK_PIN_LEN, inače obična znamenka
+// Obje vraćaju masku LOCK_ACT_* akcija koje treba izvršiti.
+void LockFsm_Init(LockFsm *f, const char *pin);
+void LockFsm_SetVerify(LockFsm *f, LockVerifyFn verify, uint8_t max_len, char enter);
+uint16_t LockFsm_Event(LockFsm *f, LockEvent ev, char key);
+uint16_t LockFsm_Key(LockFsm *f, char key);
+
+#endif // __LOCK_FSM_H__   // završetak zaštite od višestrukog uključivanja
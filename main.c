@@ -1,249 +1,441 @@
-#include "main.h"          // Uključuje osnovne definicije projekta (HAL, tipovi, prototipovi koje generira CubeMX)
-#include "i2c.h"           // Uključuje konfiguraciju i funkcije za I2C perif. (CubeMX generira i2c.c i i2c.h)
-#include "gpio.h"          // Uključuje konfiguraciju i funkcije za GPIO pinove (CubeMX generira gpio.c i gpio.h)
-#include "lcd_i2c.h"       // Uključuje našu LCD biblioteku (inicijalizacija, ispis teksta, pomicanje kursora)
-#include "keypad.h"        // Uključuje našu biblioteku za tipkovnicu 4x4 (inicijalizacija i čitanje tipke)
-#include <string.h>        // Standardna C biblioteka za rad sa stringovima (strcmp, strcpy, strcat, strlen...)
-
-#define PASSWORD_LEN  4     // Definiramo konstantu: duljina lozinke je 4 znaka
-
-// Globalne varijable za logiku brave
-char password[PASSWORD_LEN + 1] = "1234";  // Polje od 5 bajtova (4 znaka + '\0'), inicijalno "1234"
-int changeMode = 0;                        // Zastavica: 0 = normalno, 1 = mod promjene lozinke
-
-// Pinovi za LED i buzzer (definirani u CubeMX-u kao GPIO Output)
-#define LED_GPIO_Port    GPIOA        // LED se nalazi na PORT A
-#define LED_Pin          GPIO_PIN_11  // LED spojen na PA11
-#define BUZZER_GPIO_Port GPIOA        // Buzzer na PORT A
-#define BUZZER_Pin       GPIO_PIN_12  // Buzzer spojen na PA12
-
-// Tipkalo za reset (definirano u CubeMX-u kao GPIO Input s Pull-Up otpornikom)
-// Fizički tipkalo spaja pin PC13 na GND kad se pritisne
-#define RESET_GPIO_Port  GPIOC
-#define RESET_Pin        GPIO_PIN_13
-
-// Handle za I2C (objekt koji koristi HAL za upravljanje I2C1 perif.)
-extern I2C_HandleTypeDef hi2c1; // Definiran u i2c.c od CubeMX-a
-
-// -Funkcije za signalizaciju (LED i buzzer) 
-
-// Funkcija koja trepće LED-icom n puta
-// Parametri: n = broj treptaja, delay_ms = trajanje ON i OFF stanja u milisekundama
-void led_blink(int n, int delay_ms) {
-    for (int i = 0; i < n; i++) {                                 // ponavljaj n puta
-        HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET);   // LED ON (logička 1)
-        HAL_Delay(delay_ms);                                       // čekaj delay_ms ms
-        HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_RESET); // LED OFF (logička 0)
-        HAL_Delay(delay_ms);                                       // čekaj delay_ms ms
-    }
-}
-
-// Funkcija koja daje zvučni signal buzzerom n puta
-// Parametri: n = broj beepova, delay_ms = trajanje zvuka (ON) u milisekundama
-void buzzer_beep(int n, int delay_ms) {
-    for (int i = 0; i < n; i++) {                                      // ponavljaj n puta
-        HAL_GPIO_WritePin(BUZZER_GPIO_Port, BUZZER_Pin, GPIO_PIN_SET); // Uključi buzzer
-        HAL_Delay(delay_ms);                                           // čekaj dok traje zvuk
-        HAL_GPIO_WritePin(BUZZER_GPIO_Port, BUZZER_Pin, GPIO_PIN_RESET);// Isključi buzzer
-        HAL_Delay(100);                                                // kratka pauza 100 ms
-    }
-}
-
-// Funkcija koja resetira stanje sustava i vrati ekran na početnu poruku
-// Parametri su pokazivači na varijable stanja (unos, indeks, unlocked, tocno, fail_count, locked)
-void reset_unlock(char *input, int *idx, int *unlocked, int *tocno, int *fail_count, int *locked) {
-    *idx = 0;                     // reset indeksa unosa na početak
-    input[0] = '\0';              // postavi prazan string (nulti znak = terminator)
-    *unlocked = 0;                // postavi status "zaključano"
-    *tocno = 0;                   // zadnji unos nije točan
-    *fail_count = 0;              // reset broja pogrešnih pokušaja
-    *locked = 0;                  // sustav nije zaključan
-    changeMode = 0;               // izađi iz moda promjene lozinke
-
-    // Isključi LED i buzzer
-    HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(BUZZER_GPIO_Port, BUZZER_Pin, GPIO_PIN_RESET);
-
-    // Reset LCD ekrana na početnu poruku
-    lcd_i2c_clear();              // obriši ekran
-    lcd_i2c_set_cursor(0, 0);     // kursor na prvi red, prvi stupac
-    lcd_i2c_print("Upisi lozinku:"); // ispiši poruku
-    lcd_i2c_set_cursor(0, 1);     // kursor na drugi red
-    lcd_i2c_print("                "); // ispiši praznine da očisti red
-}
-
-int main(void)
-{
-    HAL_Init();          // Inicijalizacija HAL biblioteke i Systick timera
-    SystemClock_Config();// Konfiguracija sistemskog takta (definirana niže)
-    MX_GPIO_Init();      // Inicijalizacija GPIO pinova (CubeMX generira funkciju)
-    MX_I2C1_Init();      // Inicijalizacija I2C1 (CubeMX generira funkciju)
-
-    // Pokreni LCD (koristimo I2C1, adresa 0x27, LCD 16x2)
-    lcd_i2c_init(&hi2c1, 0x27, 16, 2); // inicijalizacija LCD-a
-    lcd_i2c_clear();                   // obriši ekran
-    lcd_i2c_set_cursor(0, 0);          // kursor na prvi red, prva pozicija
-    lcd_i2c_print("Upisi lozinku:");   // ispiši početnu poruku
-    lcd_i2c_set_cursor(0, 1);          // kursor na drugi red
-
-    Keypad_Init();       // Inicijalizacija tipkovnice (GPIO pinovi)
-
-    // Varijable za stanje sustava
-    char input[PASSWORD_LEN + 1] = {0}; // buffer za unos lozinke (4 znaka + terminator '\0')
-    int idx = 0;                        // trenutačni indeks unosa (0–4)
-    int unlocked = 0;                   // status otključano (1) ili zaključano (0)
-    int tocno = 0;                      // zastavica: zadnja lozinka bila točna
-    int fail_count = 0;                 // broj uzastopnih pogrešnih unosa
-    int locked = 0;                     // zastavica: 1 = sustav blokiran nakon 3 greške
-
-    // Na početku isključi LED i buzzer
-    HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(BUZZER_GPIO_Port, BUZZER_Pin, GPIO_PIN_RESET);
-
-    // Beskonačna glavna petlja
-    while (1)
-    {
-        // Provjera hardverskog tipkala (PC13, aktivno na niskom nivou)
-        if (HAL_GPIO_ReadPin(RESET_GPIO_Port, RESET_Pin) == GPIO_PIN_RESET) {
-            HAL_Delay(80); // debounce (odstranjivanje smetnji pri pritisku)
-            reset_unlock(input, &idx, &unlocked, &tocno, &fail_count, &locked); // resetiraj stanje
-            while(HAL_GPIO_ReadPin(RESET_GPIO_Port, RESET_Pin) == GPIO_PIN_RESET); // čekaj da tipkalo bude pušteno
-            HAL_Delay(80); // dodatni debounce
-        }
-
-        // Čitanje tipke s tipkovnice
-        char key = Keypad_GetKey(); // funkcija vraća znak ili 0 ako ništa nije pritisnuto
-        if (key) {                  // ako je pritisnuta tipka
-            // Ako je sustav zaključan zbog 3 greške
-            if (locked) {
-                if (key == '*') { // samo '*' resetira
-                    reset_unlock(input, &idx, &unlocked, &tocno, &fail_count, &locked);
-                }
-                HAL_Delay(200); // debounce
-                continue;       // preskoči ostatak jer je zaključano
-            }
-
-            // Ako je '*' → soft reset
-            if (key == '*') {
-                reset_unlock(input, &idx, &unlocked, &tocno, &fail_count, &locked);
-            }
-            // Ako je '#' → ulazak u mod promjene lozinke
-            else if (key == '#') {
-                changeMode = 1;         // postavi zastavicu promjene lozinke
-                idx = 0;                // reset indeksa unosa
-                input[0] = '\0';        // prazan unos
-                lcd_i2c_clear();        // očisti LCD
-                lcd_i2c_set_cursor(0, 0);
-                lcd_i2c_print("Nova lozinka:"); // poruka korisniku
-                lcd_i2c_set_cursor(0, 1);
-            }
-            // Inače unosimo lozinku znak po znak
-            else if (idx < PASSWORD_LEN) {
-                input[idx++] = key;         // spremi znak u buffer
-                input[idx] = '\0';          // dodaj terminator stringa
-                lcd_i2c_set_cursor(0, 1);   // postavi kursor na drugi red
-                lcd_i2c_print(input);       // ispiši trenutačni unos
-                for (int i = idx; i < 16; i++) lcd_i2c_print(" "); // ostatak reda ispuni prazninama
-
-                // Ako je uneseno svih 4 znaka
-                if (idx == PASSWORD_LEN) {
-                    if (changeMode) {
-                        // U modu promjene lozinke
-                        strcpy(password, input);   // spremi novu lozinku
-                        changeMode = 0;            // izađi iz moda
-                        lcd_i2c_clear();
-                        lcd_i2c_print("Lozinka promj."); // obavijest korisniku
-                        buzzer_beep(1, 200);       // zvučni signal
-                        HAL_Delay(800);            // čekaj malo
-                        reset_unlock(input, &idx, &unlocked, &tocno, &fail_count, &locked); // resetiraj stanje
-                    } else {
-                        // Provjera unosa lozinke
-                        if (strcmp(input, password) == 0) {
-                            // Ako je točno
-                            lcd_i2c_clear();
-                            lcd_i2c_print("Tocna lozinka!");
-                            HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET); // LED ON
-                            buzzer_beep(1, 200);                                     // beep
-                            tocno = 1;      // označi da je zadnji unos bio točan
-                            unlocked = 1;   // status otključano
-                            fail_count = 0; // reset broja grešaka
-                        } else {
-                            // Ako je pogrešno
-                            fail_count++;               // povećaj broj grešaka
-                            lcd_i2c_clear();
-                            lcd_i2c_print("Pogresna lozinka!");
-                            led_blink(2, 200);          // LED blink dvaput
-                            buzzer_beep(2, 120);        // buzzer beep dvaput
-                            HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_RESET); // LED OFF
-                            unlocked = 0;
-                            tocno = 0;
-                            idx = 0;         // reset unosa
-                            input[0] = '\0';
-
-                            if (fail_count >= 3) {
-                                // Zaključaj sustav
-                                locked = 1;
-                                lcd_i2c_clear();
-                                lcd_i2c_set_cursor(0, 0);
-                                lcd_i2c_print("Zakljucano!");
-                                lcd_i2c_set_cursor(0, 1);
-                                lcd_i2c_print("Reset na * ili tipk.");
-                            } else {
-                                // Vrati na početnu poruku
-                                lcd_i2c_set_cursor(0, 0);
-                                lcd_i2c_print("Upisi lozinku:");
-                                lcd_i2c_set_cursor(0, 1);
-                                lcd_i2c_print("                ");
-                            }
-                        }
-                    }
-                }
-            }
-            HAL_Delay(200); // debounce
-        }
-
-        // Ako je zadnja lozinka bila točna → LED stalno svijetli
-        if (tocno) {
-            HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET);
-        }
-    }
-}
-
-// --- Konfiguracija sistemskog takta (HSI, bez PLL-a) ---
-void SystemClock_Config(void)
-{
-  RCC_OscInitTypeDef RCC_OscInitStruct = {0};  // Struktura za konfiguraciju oscilatora
-  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};  // Struktura za konfiguraciju takta sabirnica
-
-  __HAL_RCC_PWR_CLK_ENABLE();                                      // Omogući PWR clock
-  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE3);   // Postavi naponsko skaliranje
-
-  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;       // Odaberi HSI oscilator
-  RCC_OscInitStruct.HSIState = RCC_HSI_ON;                         // Uključi HSI
-  RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT; // Kalibracija HSI
-  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;                   // Ne koristimo PLL
-  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)             // Primijeni postavke
-  {
-    Error_Handler();                                               // Ako ne uspije, idi u Error_Handler
-  }
-
-  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
-                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2; // Konfiguriraj sve sabirnice
-  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;           // SYSCLK iz HSI
-  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;               // AHB = SYSCLK / 1
-  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;                // APB1 = HCLK / 1
-  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;                // APB2 = HCLK / 1
-
-  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_0) != HAL_OK) // Primijeni clock konfiguraciju
-  {
-    Error_Handler();                                               // Ako ne uspije, idi u Error_Handler
-  }
-}
-
-// --- Funkcija za greške ---
-void Error_Handler(void)
-{
-  __disable_irq(); // Onemogući sve prekide
-  while (1) {      // Beskonačna petlja (fail-safe stanje)
-  }
-}
+#include "main.h"          // Uključuje osnovne definicije projekta (HAL, tipovi, prototipovi koje generira CubeMX)
+#include "i2c.h"           // Uključuje konfiguraciju i funkcije za I2C perif. (CubeMX generira i2c.c i i2c.h)
+#include "gpio.h"          // Uključuje konfiguraciju i funkcije za GPIO pinove (CubeMX generira gpio.c i gpio.h)
+#include "usart.h"         // Uključuje konfiguraciju USART2 (CubeMX generira usart.c i usart.h, TX preko DMA)
+#include "tim.h"           // Uključuje konfiguraciju TIM1 (CubeMX generira tim.c i tim.h, PWM + DMA)
+#include "i2c_bus.h"       // Uključuje zajedničku I2C sabirnicu s redom prijenosa (više LCD-ova na I2C1)
+#include "lcd_i2c.h"       // Uključuje našu LCD biblioteku (inicijalizacija, ispis teksta, pomicanje kursora)
+#include "keypad.h"        // Uključuje našu biblioteku za tipkovnicu 4x4 (inicijalizacija i čitanje tipke)
+#include "sched.h"         // Uključuje kooperativni scheduler (timeri umjesto HAL_Delay-a)
+#include "lock_fsm.h"      // Uključuje logiku brave (automat stanja bez HAL poziva)
+#include "audit.h"         // Uključuje dnevnik pristupa (prsten u RAM-u, slanje preko UART DMA)
+#include "prof.h"          // Uključuje mjerenje trajanja preko DWT->CYCCNT (samo uz PROF_ENABLE=1)
+#include "power.h"         // Uključuje mirovanje (Sleep/STOP) i buđenje tipkovnicom preko EXTI
+#include "clock.h"         // Uključuje profile takta (IDLE na HSI, BURST na PLL-u s I2C od 400 kHz)
+#include "pattern.h"       // Uključuje uzorke za LED i buzzer (TIM1 PWM + DMA, bez procesora)
+#include "pin_store.h"     // Uključuje trajnu pohranu lozinke u flashu (dnevnik zapisa u dva sektora)
+#include "cred.h"          // Uključuje tablicu korisničkih lozinaka u flashu (hash indeks, uloge)
+#include "timebase.h"      // Uključuje mikrosekundni sat na TIM5 (čekanja naredbi LCD-a)
+
+// Vremena (u ms) koja su prije bila HAL_Delay-i, sada ih odbrojava scheduler
+#define MSG_WRONG_MS     1200  // koliko dugo stoji poruka "Pogresna lozinka!"
+#define MSG_CHANGED_MS   1100  // koliko dugo stoji poruka "Lozinka promj." prije reseta
+#define RESET_DEBOUNCE_MS  80  // tipkalo PC13 mora biti stabilno 80 ms
+#define RESET_POLL_MS      10  // koliko često provjeravamo tipkalo PC13
+#define SERVICE_SHOW_MS  2000  // koliko dugo stoji servisni zaslon nakon akorda
+#define WRONG_BAR_MS      100  // korak trake na poruci "Pogresna lozinka!"
+
+#define DEFAULT_PASSWORD "1234"   // Tvornička lozinka (dok u flashu nije spremljena nijedna)
+
+// --- Raspored flasha (flash_layout.h; čip s barem 8 sektora, npr. F401xE s 512 KB) ---
+// Kod smije zauzeti samo sektore ispred tablice korisnika (na F401xE sektore 0–4, prvih
+// 128 KB). Iza njih su podaci koje firmware briše: tablica korisnika i dnevnik lozinke
+// (zadnja tri sektora čipa). U CubeMX linker skripti FLASH regija mora imati LENGTH =
+// FLASH_APP_SIZE (128K na F401xE), pa linker sam odbije prevelik kod; flash_image_fits()
+// to pri pokretanju provjeri i iz simbola linker skripte.
+#define FLASH_APP_SIZE   FLASH_LAYOUT_OFS(CRED_SECTOR)
+
+_Static_assert(FLASH_APP_SIZE <= CRED_OFS, "tablica korisnika je u području koda");
+_Static_assert(CRED_SECTOR >= FLASH_SECTOR_5, "tablica korisnika mora biti u sektoru od 128 KB");
+_Static_assert(CRED_OFS + CRED_SECTOR_SIZE <= PIN_STORE_OFS_A, "tablica korisnika i lozinka se preklapaju");
+_Static_assert(PIN_STORE_OFS_A + PIN_STORE_SECTOR_SIZE <= PIN_STORE_OFS_B, "sektori lozinke se preklapaju");
+_Static_assert(FLASH_LAYOUT_SIZE(PIN_STORE_SECTOR_B) == PIN_STORE_SECTOR_SIZE, "sektori lozinke nisu iste veličine");
+_Static_assert(PIN_STORE_OFS_B + PIN_STORE_SECTOR_SIZE == FLASH_LAYOUT_DEVICE, "dnevnik lozinke nije na kraju flasha čipa");
+
+// Stanje brave: unos, broj grešaka, lozinka i trenutno stanje (vidi lock_fsm.h)
+static LockFsm lock;
+
+// Tipkalo za reset (definirano u CubeMX-u kao GPIO Input s Pull-Up otpornikom)
+// Fizički tipkalo spaja pin PC13 na GND kad se pritisne
+#define RESET_GPIO_Port  GPIOC
+#define RESET_Pin        GPIO_PIN_13
+
+// Handle za I2C (objekt koji koristi HAL za upravljanje I2C1 perif.)
+extern I2C_HandleTypeDef hi2c1; // Definiran u i2c.c od CubeMX-a
+
+// Ploča vrata: LCD na I2C1 (adresa 0x27) i tipkovnica spojena prema keypad_layout.h.
+// Za dodatna vrata dovoljno je dodati još jedan LcdI2c (druga adresa, ista sabirnica)
+// i Keypad s vlastitim KeypadPins.
+static I2cBus i2c1_bus;
+static LcdI2c lcd;
+static Keypad keypad;
+static const KeypadPins keypad_pins = KEYPAD_PINS_DEFAULT;
+static Keypad *const keypads[] = { &keypad };
+
+// SysTick prekid (svake 1 ms) → jedan korak skeniranja tipkovnice u pozadini.
+// HAL ga poziva iz HAL_SYSTICK_IRQHandler(), pa SysTick_Handler u stm32f4xx_it.c
+// uz HAL_IncTick() mora pozivati i HAL_SYSTICK_IRQHandler().
+void HAL_SYSTICK_Callback(void) {
+    Keypad_ScanTick(&keypad);
+}
+
+// Funkcija koja postavlja oba reda zaslona i šalje samo promijenjene znakove
+// (bez lcd_i2c_clear() i njegovih 2 ms čekanja)
+void lcd_show(const char *line0, const char *line1) {
+    lcd_i2c_fb_line(&lcd, 0, line0);  // prvi red u framebuffer
+    lcd_i2c_fb_line(&lcd, 1, line1);  // drugi red u framebuffer
+    lcd_i2c_flush(&lcd);              // pošalji samo razlike
+}
+
+// Ikona u zadnjem stupcu prvog reda (lokot); ikone su u CGRAM-u pa se šalju samo jednom
+static void lcd_icon(uint8_t glyph) {
+    lcd_i2c_fb_glyph(&lcd, lcd.cols - 1, 0, glyph);
+}
+
+// Unos lozinke na zaslonu: točka umjesto svakog upisanog znaka
+static void lcd_show_masked(const char *line0) {
+    char mask[LOCK_PIN_MAX + 1];
+    char dot = lcd_i2c_glyph(&lcd, LCD_GLYPH_DOT);
+    for (uint8_t i = 0; i < lock.idx; i++) mask[i] = dot;
+    mask[lock.idx] = '\0';
+    lcd_i2c_fb_line(&lcd, 0, line0);
+    lcd_i2c_fb_line(&lcd, 1, mask);
+    lcd_icon(LCD_GLYPH_LOCK);
+    lcd_i2c_flush(&lcd);
+}
+
+// Poruka o grešci: traka pokazuje koliko još traje (nakon zadnje greške, do blokade)
+static uint32_t wrong_since;
+
+static void lcd_show_wrong(void) {
+    uint32_t left = MSG_WRONG_MS - (HAL_GetTick() - wrong_since);
+    if (left > MSG_WRONG_MS) left = 0;                // vrijeme je isteklo (ili je tick preskočio)
+    lcd_i2c_fb_line(&lcd, 0, "Pogresna lozinka!");
+    lcd_i2c_fb_line(&lcd, 1, "");
+    lcd_i2c_fb_bar(&lcd, 0, 1, lcd.cols, left, MSG_WRONG_MS);
+    lcd_i2c_flush(&lcd);
+}
+
+// Zaslon za trenutno stanje brave (flush šalje samo ono što se promijenilo)
+static void lock_render(void) {
+    switch (lock.state) {
+    case LOCK_ST_ENTRY:   lcd_show_masked("Upisi lozinku:");              break;
+    case LOCK_ST_CHANGE:  lcd_show_masked("Nova lozinka:");               break;
+    case LOCK_ST_OPEN:
+        lcd_i2c_fb_line(&lcd, 0, "Tocna lozinka!");
+        lcd_i2c_fb_line(&lcd, 1, "");
+        lcd_icon(LCD_GLYPH_UNLOCK);
+        lcd_i2c_flush(&lcd);
+        break;
+    case LOCK_ST_WRONG:   lcd_show_wrong();                               break;
+    case LOCK_ST_CHANGED: lcd_show("Lozinka promj.", "");                  break;
+    case LOCK_ST_BLOCKED:
+        lcd_i2c_fb_line(&lcd, 0, "Zakljucano!");
+        lcd_i2c_fb_line(&lcd, 1, "Reset na * ili tipk.");
+        lcd_icon(LCD_GLYPH_LOCK);
+        lcd_i2c_flush(&lcd);
+        break;
+    default: break;
+    }
+}
+
+// Traka na poruci o grešci: iscrtava se svakih WRONG_BAR_MS dok poruka stoji
+// (nepromijenjene ćelije i ikone koje su već u CGRAM-u ne idu na sabirnicu)
+static void wrong_bar_task(void *arg) {
+    (void)arg;
+    if (lock.state != LOCK_ST_WRONG) {
+        Sched_Cancel(wrong_bar_task, 0);
+        return;
+    }
+    lcd_show_wrong();
+}
+
+// Upis broja u string bez sprintf-a, vraća pokazivač iza zadnje znamenke
+static char *fmt_u32(char *p, uint32_t v) {
+    char tmp[10];
+    int n = 0;
+    do { tmp[n++] = '0' + v % 10; v /= 10; } while (v);
+    while (n) *p++ = tmp[--n];
+    *p = '\0';
+    return p;
+}
+
+// Kraj servisnog zaslona → vrati zaslon brave
+static void service_end(void *arg) {
+    (void)arg;
+    lock_render();
+}
+
+// Servisni zaslon: izgubljeni događaji tipkovnice i broj uzoraka duha
+static void service_show(void) {
+    char line[21] = "izg:";
+    char *p = fmt_u32(line + 4, Keypad_Dropped(&keypad));
+    p[0] = ' '; p[1] = 'd'; p[2] = 'u'; p[3] = 'h'; p[4] = ':';
+    fmt_u32(p + 5, Keypad_Ghosts(&keypad));
+    lcd_show("Servis", line);
+    Sched_Start(service_end, 0, SERVICE_SHOW_MS, 0);
+}
+
+// Akord s tipkovnice (dvije tipke držane zajedno)
+static void keypad_chord(char code) {
+    switch (code) {
+    case KEYPAD_CHORD_SERVICE:
+        Audit_Record(AUDIT_EV_SERVICE, lock.fails);
+        Prof_DumpStart();                     // statistika profiliranja ide za zapisom kroz dnevnik
+        service_show();
+        break;
+    case KEYPAD_CHORD_DURESS:
+        // Tihi alarm: namjerno bez ikakvog traga na zaslonu, LED-u ili buzzeru, samo zapis u dnevniku
+        Audit_Record(AUDIT_EV_DURESS, lock.fails);
+        break;
+    default:
+        break;
+    }
+}
+
+// Zapis u dnevnik pristupa kad brava promijeni stanje
+// (broj grešaka se pamti od prije događaja jer ga otključavanje i reset brišu)
+static void lock_audit(void) {
+    static LockState last = LOCK_ST_ENTRY;
+    static uint8_t last_fails = 0;
+    if (lock.state != last) {
+        switch (lock.state) {
+        case LOCK_ST_OPEN:    Audit_Record(AUDIT_EV_CORRECT, last_fails); break;
+        case LOCK_ST_WRONG:   Audit_Record(AUDIT_EV_WRONG, lock.fails);   break;
+        case LOCK_ST_BLOCKED: Audit_Record(AUDIT_EV_LOCKOUT, lock.fails); break;
+        case LOCK_ST_CHANGED: Audit_Record(AUDIT_EV_PIN_CHG, last_fails); break;
+        default: break;
+        }
+        last = lock.state;
+    }
+    last_fails = lock.fails;
+}
+
+#ifndef SIM_FLASH_SIZE
+extern const uint8_t _sidata[], _sdata[], _edata[];   // CubeMX linker skripta (.data u flashu i RAM-u)
+#endif
+
+// Završava li slika firmware-a (kod, konstante i početne vrijednosti .data) prije sektora podataka
+// i ima li čip sve sektore rasporeda (FLASHSIZE_BASE: veličina flasha u KB koju javlja sam čip;
+// firmware preveden za F401xE upisan u F401xC brisao bi nepostojeće sektore)
+static int flash_image_fits(void) {
+    if ((uint32_t)*(const volatile uint16_t *)FLASHSIZE_BASE * 1024U < FLASH_LAYOUT_END) return 0;
+#ifdef SIM_FLASH_SIZE
+    return 1;                                         // simulator nema linker skriptu
+#else
+    return (uintptr_t)_sidata + (uintptr_t)(_edata - _sdata) <= FLASH_BASE + FLASH_APP_SIZE;
+#endif
+}
+
+static void lock_timeout(void *arg);   // definirana niže, lock_apply() je pokreće i poništava
+
+// Uključi tablicu korisnika (KEYPAD_KEY_ENTER postaje tipka predaje kraćih lozinki). Glavna
+// lozinka spremljena prije tablice smije sadržavati tu tipku i tada se više ne bi dala upisati,
+// pa tablica ostaje isključena dok se lozinka ne promijeni s '#' (nova lozinka ne smije imati
+// tu tipku). To se bilježi u dnevnik (AUDIT_EV_USERS_OFF), da brava bez korisnika ne radi tiho.
+static void lock_users_enable(void) {
+    uint8_t clash = 0;
+    for (int i = 0; i < LOCK_PIN_LEN; i++) {
+        clash |= (KEYPAD_KEY_ENTER != 0 && lock.pin[i] == KEYPAD_KEY_ENTER);
+    }
+    if (clash && Cred_MaxLen() > LOCK_PIN_LEN) {
+        LockFsm_SetVerify(&lock, 0, 0, KEYPAD_KEY_ENTER);   // tipka predaje je za sada znamenka
+        Audit_Record(AUDIT_EV_USERS_OFF, 0);
+        return;
+    }
+    LockFsm_SetVerify(&lock, Cred_Verify, Cred_MaxLen(), KEYPAD_KEY_ENTER);
+}
+
+// Izvrši akcije koje je vratio automat stanja (jedino mjesto gdje logika brave dira hardver)
+static void lock_apply(uint16_t act) {
+    lock_audit();
+    if (act & LOCK_ACT_PIN_SAVE) {                  // prije uzorka: sažimanje briše sektor i blokira
+        if (!PinStore_Save(lock.pin, LOCK_PIN_LEN)) Audit_Record(AUDIT_EV_PIN_STORE, lock.fails);
+        if (!lock.verify) lock_users_enable();      // stara lozinka s tipkom predaje je zamijenjena
+    }
+    if (act & LOCK_ACT_OUTPUTS_OFF) {               // ugasi LED i buzzer
+        Pattern_Stop();
+        Pattern_Led(0);
+    }
+    if (act & LOCK_ACT_TIMER_STOP) {                // poništi privremenu poruku
+        Sched_Cancel(lock_timeout, 0);
+    }
+    if (act & LOCK_ACT_TIMER_START) {               // poruka stoji određeno vrijeme
+        Sched_Start(lock_timeout, 0, (lock.state == LOCK_ST_CHANGED) ? MSG_CHANGED_MS : MSG_WRONG_MS, 0);
+        if (lock.state == LOCK_ST_WRONG) {          // traka odbrojava poruku
+            wrong_since = HAL_GetTick();
+            Sched_Start(wrong_bar_task, 0, WRONG_BAR_MS, WRONG_BAR_MS);
+        }
+    }
+    if (act & LOCK_ACT_LED_ON) {
+        Pattern_Led(1);                             // LED ON (i nakon uzorka)
+    }
+    // Uzorci sviraju u hardveru (TIM1 + DMA), ovdje se samo pokreću
+    if (act & LOCK_ACT_BEEP_OK) {
+        Pattern_Play(lock.state == LOCK_ST_CHANGED ? PATTERN_CHANGED : PATTERN_OK);
+    }
+    if (act & LOCK_ACT_SIGNAL_ERR) {
+        Pattern_Play(PATTERN_ERROR);                // LED i nizak ton dvaput
+    }
+    if (act & LOCK_ACT_SIGNAL_LOCK) {
+        Pattern_Play(PATTERN_LOCKOUT);              // tri silazna tona
+    }
+    if (act & LOCK_ACT_REDRAW) {
+        lock_render();
+    }
+}
+
+// Istek privremene poruke (poziva ga scheduler)
+static void lock_timeout(void *arg) {
+    (void)arg;
+    lock_apply(LockFsm_Event(&lock, LOCK_EV_TIMEOUT, 0));
+}
+
+// Periodička provjera hardverskog tipkala (PC13, aktivno na niskom nivou).
+// Promjena se prihvaća tek kad je pin stabilan RESET_DEBOUNCE_MS (debounce bez čekanja).
+static void reset_button_task(void *arg) {
+    static GPIO_PinState last = GPIO_PIN_SET;     // zadnje očitano stanje pina
+    static GPIO_PinState stable = GPIO_PIN_SET;   // potvrđeno stanje (SET = pušteno)
+    static uint32_t since = 0;                    // od kada je pin u stanju 'last'
+    (void)arg;
+
+    GPIO_PinState now = HAL_GPIO_ReadPin(RESET_GPIO_Port, RESET_Pin);
+    if (now != last) {            // pin se promijenio → kreni mjeriti ispočetka
+        last = now;
+        since = HAL_GetTick();
+        return;
+    }
+    if (now == stable || HAL_GetTick() - since < RESET_DEBOUNCE_MS) return;
+
+    stable = now;
+    if (stable == GPIO_PIN_RESET) {
+        Audit_Record(AUDIT_EV_HW_RESET, lock.fails);
+        lock_apply(LockFsm_Event(&lock, LOCK_EV_RESET, 0)); // pritisak potvrđen → resetiraj stanje
+    }
+}
+
+int main(void)
+{
+    HAL_Init();          // Inicijalizacija HAL biblioteke i Systick timera
+    SystemClock_Config();// Konfiguracija sistemskog takta (definirana niže)
+    MX_GPIO_Init();      // Inicijalizacija GPIO pinova (CubeMX generira funkciju)
+    MX_I2C1_Init();      // Inicijalizacija I2C1 (CubeMX generira funkciju)
+    MX_USART2_UART_Init(); // Inicijalizacija USART2 za dnevnik pristupa (CubeMX generira funkciju)
+    MX_TIM1_Init();      // Inicijalizacija TIM1 i DMA2 tokova za LED/buzzer (CubeMX generira funkciju)
+    MX_TIM5_Init();      // Inicijalizacija TIM5 kao 32-bitnog brojila (CubeMX generira funkciju)
+    Timebase_Init(&htim5); // Mikrosekundni sat za čekanja LCD-a
+    Audit_Init(&huart2); // Dnevnik pristupa šalje zapise preko USART2
+    Prof_Init();         // Brojač ciklusa za profiliranje (bez učinka ako PROF_ENABLE nije 1)
+
+    // Pokreni LCD (koristimo I2C1, adresa 0x27, LCD 16x2)
+    I2cBus_Init(&i2c1_bus, &hi2c1);    // red prijenosa za sve uređaje na I2C1
+    // Pokretanje ide na brzom taktu (I2C1 na 400 kHz); glavna petlja vraća CLOCK_IDLE kad se
+    // prvi ispis pošalje
+    Clock_SetProfile(CLOCK_BURST);
+    // Reset bez nestanka napajanja (watchdog, NRST, softverski): LCD je ostao uključen
+    // i u 4-bitnom načinu, pa se puni reset slijed preskače
+    if (__HAL_RCC_GET_FLAG(RCC_FLAG_PORRST) || __HAL_RCC_GET_FLAG(RCC_FLAG_BORRST)) {
+        lcd_i2c_init(&lcd, &i2c1_bus, 0x27, 16, 2);      // inicijalizacija LCD-a (zaslon je nakon nje prazan)
+    } else {
+        lcd_i2c_init_warm(&lcd, &i2c1_bus, 0x27, 16, 2); // isto, bez čekanja uključenja LCD-a
+    }
+    __HAL_RCC_CLEAR_RESET_FLAGS();     // tek sad: reset prije kraja inicijalizacije opet ide hladnim putem
+    char pin[LOCK_PIN_LEN + 1];        // zadnja spremljena lozinka ili tvornička
+    if (!flash_image_fits()) Error_Handler(); // brisanje sektora podataka obrisalo bi kod (ili ih nema)
+    PinStore_Init();                   // nađi zadnji zapis u flashu (bez čitanja cijelog dnevnika)
+    if (PinStore_Load(pin, LOCK_PIN_LEN) != LOCK_PIN_LEN) {
+        for (int i = 0; i <= LOCK_PIN_LEN; i++) pin[i] = DEFAULT_PASSWORD[i];
+    }
+    LockFsm_Init(&lock, pin);          // početno stanje brave
+    Cred_Init();                       // tablica korisnika (čita se samo zaglavlje)
+    lock_users_enable();               // uz glavnu lozinku vrijede i korisničke
+    lock_render();                     // ispiši početnu poruku
+
+    Keypad_Init(&keypad, &keypad_pins); // Inicijalizacija tipkovnice (skener radi u SysTick prekidu)
+    Power_Init(keypads, sizeof(keypads) / sizeof(keypads[0])); // EXTI na kolonama i PC13 za buđenje iz STOP-a
+
+    Pattern_Init();      // Na početku isključi LED i buzzer
+
+    // Tipkalo PC13 provjeravamo periodički preko schedulera
+    Sched_Start(reset_button_task, 0, 0, RESET_POLL_MS);
+
+    // Beskonačna glavna petlja – obradi ono što je spremno pa spavaj do sljedećeg prekida
+    while (1)
+    {
+        PROF_BEGIN(LOOP);
+
+        PROF_BEGIN(SCHED);
+        Sched_Run();     // dospjeli timeri: poruke, servisni zaslon, tipkalo PC13
+        PROF_END(SCHED);
+
+        // Obrada svih događaja s tipkovnice koji su se skupili u redu
+        // (provjera PIN-a i crtanje idu na brzom taktu ako ga se može uključiti)
+        PROF_BEGIN(KEYS);
+        if (Keypad_Pending(&keypad)) Clock_SetProfile(CLOCK_BURST);
+        KeypadEvent ev;
+        while (Keypad_PollEvent(&keypad, &ev)) {
+            if (ev.type == KEYPAD_EVENT_CHORD) {           // akord ne ide u automat brave
+                keypad_chord(ev.key);
+                continue;
+            }
+            if (ev.type != KEYPAD_EVENT_PRESS) continue;   // otpuštanja ne koristimo
+            Sched_InputLatency(ev.tick);                   // izmjeri kašnjenje od pritiska do obrade
+            lock_apply(LockFsm_Key(&lock, ev.key));        // automat stanja + izvršavanje akcija
+        }
+        PROF_END(KEYS);
+
+        PROF_BEGIN(AUDIT);
+        Prof_Poll();     // statistika profiliranja u dnevnik, ako je slanje pokrenuto
+        Audit_Poll();    // ako UART miruje, pošalji sljedeći blok zapisa iz dnevnika
+        PROF_END(AUDIT);
+
+        Pattern_Poll();  // uzorak je odsviran → pospremi DMA, LED na trajno stanje
+
+        PROF_END(LOOP);
+
+        // Kad je crtanje i slanje gotovo, natrag na spori takt
+        if (!Keypad_Pending(&keypad) && !I2cBus_AnyBusy() && !Audit_Busy()) Clock_SetProfile(CLOCK_IDLE);
+
+        uint8_t idle = Keypad_Idle(&keypad) && Sched_Idle() && !I2cBus_AnyBusy() && !Audit_Busy()
+                       && !Pattern_Busy() && Clock_GetProfile() == CLOCK_IDLE;
+
+        // Prije STOP-a, dok brava čeka unos: drugi sektor lozinke se obriše unaprijed (CPU stoji
+        // 1–2 s, jednom nakon sažimanja), pa promjena lozinke nikad ne čeka brisanje. Ako je
+        // flash radio, prošlo je vrijeme pa se stanje provjerava ispočetka.
+        if (idle && lock.state == LOCK_ST_ENTRY && lock.idx == 0 && PinStore_Prepare()) continue;
+
+        // Spavaj do sljedećeg prekida; ako baš ništa ne radi, STOP do pritiska tipke
+        Power_Idle(idle);
+    }
+}
+
+// --- Konfiguracija sistemskog takta (HSI, bez PLL-a) ---
+// Ovo je profil CLOCK_IDLE (vidi clock.h); poziva se nakon reseta i nakon buđenja iz STOP-a.
+// Brzi profil CLOCK_BURST (PLL 84 MHz) uključuje Clock_SetProfile() samo dok se obrađuje unos.
+void SystemClock_Config(void)
+{
+  RCC_OscInitTypeDef RCC_OscInitStruct = {0};  // Struktura za konfiguraciju oscilatora
+  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};  // Struktura za konfiguraciju takta sabirnica
+
+  __HAL_RCC_PWR_CLK_ENABLE();                                      // Omogući PWR clock
+  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE3);   // Postavi naponsko skaliranje
+
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;       // Odaberi HSI oscilator
+  RCC_OscInitStruct.HSIState = RCC_HSI_ON;                         // Uključi HSI
+  RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT; // Kalibracija HSI
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;                   // Ne koristimo PLL
+  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)             // Primijeni postavke
+  {
+    Error_Handler();                                               // Ako ne uspije, idi u Error_Handler
+  }
+
+  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
+                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2; // Konfiguriraj sve sabirnice
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;           // SYSCLK iz HSI
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV4;               // AHB = SYSCLK / 4 (4 MHz, profil CLOCK_IDLE)
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;                // APB1 = HCLK / 1
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;                // APB2 = HCLK / 1
+
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_0) != HAL_OK) // Primijeni clock konfiguraciju
+  {
+    Error_Handler();                                               // Ako ne uspije, idi u Error_Handler
+  }
+}
+
+// --- Funkcija za greške ---
+void Error_Handler(void)
+{
+  __disable_irq(); // Onemogući sve prekide
+  while (1) {      // Beskonačna petlja (fail-safe stanje)
+  }
+}
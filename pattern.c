@@ -0,0 +1,153 @@
+#include "pattern.h"   // Uključujemo header file s deklaracijama i HAL funkcijama
+#include "tim.h"       // htim1 i njegovi DMA tokovi (CubeMX)
+
+// --- Tablice uzoraka (u flashu; DMA ih čita izravno) ---
+static const PatternStep pattern_ok[] = {
+    PATTERN_TONE(2000, 100, 100),
+    PATTERN_TONE(2000, 100, 100),           // 200 ms ton, LED upaljen
+    PATTERN_END
+};
+
+static const PatternStep pattern_error[] = {
+    PATTERN_TONE(500, 120, 100),            // dvaput: nizak ton 120 ms, LED 200 ms
+    PATTERN_REST(80, 100),
+    PATTERN_REST(200, 0),
+    PATTERN_TONE(500, 120, 100),
+    PATTERN_REST(80, 100),
+    PATTERN_REST(200, 0),
+    PATTERN_END
+};
+
+static const PatternStep pattern_lockout[] = {
+    PATTERN_TONE(1000, 250, 100),           // tri silazna tona
+    PATTERN_REST(50, 0),
+    PATTERN_TONE(800, 250, 100),
+    PATTERN_REST(50, 0),
+    PATTERN_TONE(600, 400, 100),
+    PATTERN_END
+};
+
+static const PatternStep pattern_changed[] = {
+    PATTERN_TONE(1500, 100, 100),           // tri uzlazna tona
+    PATTERN_TONE(2000, 100, 100),
+    PATTERN_TONE(2500, 100, 100),
+    PATTERN_END
+};
+
+#define PATTERN_ENTRY(t) { (t), sizeof(t) / sizeof((t)[0]) }
+
+static const struct {
+    const PatternStep *steps;
+    uint16_t count;
+} pattern_table[PATTERN_COUNT] = {
+    [PATTERN_OK]      = PATTERN_ENTRY(pattern_ok),
+    [PATTERN_ERROR]   = PATTERN_ENTRY(pattern_error),
+    [PATTERN_LOCKOUT] = PATTERN_ENTRY(pattern_lockout),
+    [PATTERN_CHANGED] = PATTERN_ENTRY(pattern_changed),
+};
+
+// Riječi koje DMA piše u GPIOA->BSRR (gornjih 16 bitova briše pin)
+static const uint32_t pattern_buzz_set = PATTERN_BUZZER_PIN;
+static const uint32_t pattern_buzz_clr = (uint32_t)PATTERN_BUZZER_PIN << 16;
+
+#define PATTERN_BURST_LEN   (sizeof(PatternStep) / sizeof(uint16_t))   // 6 registara
+#define PATTERN_OC4M(mode)  ((uint32_t)(mode) << 8)                      // OC1M → OC4M u CCMR2
+
+_Static_assert(sizeof(PatternStep) == 6 * sizeof(uint16_t), "PatternStep mora odgovarati burstu ARR..CCR4");
+
+static volatile uint8_t playing;   // uzorak svira (briše ga Pattern_Poll/Pattern_Stop)
+static uint8_t led_hold;           // trajno stanje LED-a izvan uzorka
+
+// - LED izvan uzorka: CH4 u prisilnom stanju, brojilo stoji
+static void pattern_hold(void) {
+    TIM_TypeDef *tim = PATTERN_TIM;
+    MODIFY_REG(tim->CCMR2, TIM_CCMR2_OC4M,
+               PATTERN_OC4M(led_hold ? TIM_OCMODE_FORCED_ACTIVE : TIM_OCMODE_FORCED_INACTIVE));
+    SET_BIT(tim->CCER, TIM_CCER_CC4E);
+    SET_BIT(tim->BDTR, TIM_BDTR_MOE);       // napredni timer: bez MOE nema izlaza
+}
+
+// - Kraj reprodukcije (timer već stoji): ugasi DMA zahtjeve i tokove, buzzer LOW
+static void pattern_finish(void) {
+    TIM_TypeDef *tim = PATTERN_TIM;
+    HAL_TIM_DMABurst_WriteStop(&htim1, TIM_DMA_UPDATE);
+    __HAL_TIM_DISABLE_DMA(&htim1, TIM_DMA_CC1 | TIM_DMA_CC2);
+    HAL_DMA_Abort(htim1.hdma[TIM_DMA_ID_CC1]);
+    HAL_DMA_Abort(htim1.hdma[TIM_DMA_ID_CC2]);
+    CLEAR_BIT(tim->CR1, TIM_CR1_OPM);
+    WRITE_REG(PATTERN_BUZZER_PORT->BSRR, pattern_buzz_clr);
+    pattern_hold();
+    playing = 0;
+}
+
+// - Inicijalizacija (nakon MX_TIM1_Init)
+void Pattern_Init(void) {
+    led_hold = 0;
+    playing = 0;
+    Pattern_Retime();
+    WRITE_REG(PATTERN_BUZZER_PORT->BSRR, pattern_buzz_clr);
+    pattern_hold();
+}
+
+// - Pokreni uzorak: početno stanje je pauza, a UG odmah povlači prvi korak u preload
+void Pattern_Play(PatternId id) {
+    TIM_TypeDef *tim = PATTERN_TIM;
+    if ((unsigned)id >= PATTERN_COUNT) return;
+    if (playing) Pattern_Stop();
+
+    const PatternStep *p = pattern_table[id].steps;
+    tim->ARR = PATTERN_REST_ARR;             // prva perioda: 1 ms tišine dok se učita korak 0
+    tim->RCR = 0;
+    tim->CCR1 = PATTERN_SILENT;
+    tim->CCR2 = PATTERN_REST_ARR;
+    tim->CCR4 = 0;
+    tim->CNT = 0;
+    MODIFY_REG(tim->CCMR2, TIM_CCMR2_OC4M, PATTERN_OC4M(TIM_OCMODE_PWM1));
+
+    HAL_DMA_Start(htim1.hdma[TIM_DMA_ID_CC1], (uintptr_t)&pattern_buzz_set,
+                  (uintptr_t)&PATTERN_BUZZER_PORT->BSRR, 1);
+    HAL_DMA_Start(htim1.hdma[TIM_DMA_ID_CC2], (uintptr_t)&pattern_buzz_clr,
+                  (uintptr_t)&PATTERN_BUZZER_PORT->BSRR, 1);
+    __HAL_TIM_ENABLE_DMA(&htim1, TIM_DMA_CC1 | TIM_DMA_CC2);
+    HAL_TIM_DMABurst_MultiWriteStart(&htim1, TIM_DMABASE_ARR, TIM_DMA_UPDATE, (uint32_t *)p,
+                                     TIM_DMABURSTLENGTH_6TRANSFERS,
+                                     pattern_table[id].count * PATTERN_BURST_LEN);
+
+    playing = 1;
+    HAL_TIM_GenerateEvent(&htim1, TIM_EVENTSOURCE_UPDATE);  // pauza aktivna, korak 0 u preload
+    SET_BIT(tim->CR1, TIM_CR1_CEN);         // dalje sve radi hardver
+}
+
+// - Prekini uzorak odmah
+void Pattern_Stop(void) {
+    if (!playing) return;
+    CLEAR_BIT(PATTERN_TIM->CR1, TIM_CR1_CEN);
+    pattern_finish();
+}
+
+// - Trajno stanje LED-a (uzorak koji svira ga ne mijenja, primijeni se na kraju)
+void Pattern_Led(uint8_t on) {
+    led_hold = on ? 1 : 0;
+    if (!playing) pattern_hold();
+}
+
+// - Timer je u one-pulse modu stao na kraju zadnjeg koraka → pospremi
+void Pattern_Poll(void) {
+    if (playing && !(READ_REG(PATTERN_TIM->CR1) & TIM_CR1_CEN)) pattern_finish();
+}
+
+uint8_t Pattern_Busy(void) {
+    return playing;
+}
+
+// - APB2 timer takt se mijenja s profilom takta; PSC ima preload pa vrijedi od idućeg UEV-a
+void Pattern_Retime(void) {
+    PATTERN_TIM->PSC = HAL_RCC_GetPCLK2Freq() / PATTERN_TICK_HZ - 1U;
+}
+
+// DMA je upisao zadnji korak (PATTERN_END) u preload: zadnji stvarni korak upravo
+// svira, a one-pulse mod zaustavlja brojilo na njegovom kraju
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    if (htim->Instance != PATTERN_TIM) return;
+    SET_BIT(htim->Instance->CR1, TIM_CR1_OPM);
+}
@@ -0,0 +1,111 @@
+#ifndef __PATTERN_H__      // Ako __PATTERN_H__ nije već definiran...
+#define __PATTERN_H__      // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog TIM/DMA tipova i HAL funkcija
+#include "stm32f4xx_hal.h"
+
+// --- Uzorci za LED i buzzer u hardveru (TIM1 + DMA2) ---
+// Cijeli uzorak (npr. "točno", "greška") je tablica koraka u flashu. Procesor samo
+// pokrene reprodukciju, a dalje sve radi TIM1 s tri DMA toka:
+//
+//   PA11 = TIM1_CH4 (AF1)  → PWM za svjetlinu LED-a (CCR4)
+//   PA12                   → buzzer; PA12 nema izlaz timera (samo TIM1_ETR), pa ga
+//                            DMA2 pri usporedbama CH1/CH2 piše u GPIOA->BSRR:
+//                            CC1 (sredina periode) postavlja, CC2 (kraj) briše pin
+//   TIM1_UP                → DMA burst (TIMx_DMAR) kod svakog update događaja upisuje
+//                            sljedeći korak: ARR, RCR, CCR1, CCR2, CCR3, CCR4
+//
+// Perioda timera je perioda tona, a RCR broji koliko perioda korak traje. Tišina
+// je CCR1 > ARR (usporedba CH1 se nikad ne dogodi pa se pin ne postavlja).
+// Registri su s preloadom, pa korak upisan pri jednom update događaju vrijedi od
+// sljedećeg. Kad DMA upiše zadnji korak tablice (PATTERN_END), prekid završetka
+// DMA-a uključi one-pulse mod: timer stane na kraju zadnjeg stvarnog koraka, a
+// Pattern_Poll() iz glavne petlje pospremi DMA i vrati LED na trajno stanje.
+//
+// CubeMX: TIM1 PWM Generation CH4, Auto-reload preload Enable; DMA2 Stream1
+// (TIM1_CH1) i Stream2 (TIM1_CH2) Memory→Peripheral, Circular, Word;
+// DMA2 Stream5 (TIM1_UP) Memory→Peripheral, Normal, Half Word; prekid DMA2 Stream5.
+//
+// TIM1 je u STOP-u zaustavljen, pa se u STOP ne smije dok uzorak svira (Pattern_Busy).
+
+#define PATTERN_TIM           TIM1
+#define PATTERN_LED_PORT      GPIOA
+#define PATTERN_LED_PIN       GPIO_PIN_11   // TIM1_CH4
+#define PATTERN_BUZZER_PORT   GPIOA
+#define PATTERN_BUZZER_PIN    GPIO_PIN_12   // GPIO izlaz, piše ga DMA
+
+#define PATTERN_TICK_HZ       1000000U      // takt brojila TIM1 nakon preskalera (1 µs)
+#define PATTERN_REST_ARR      999U          // perioda u pauzi: 1 ms (LED PWM 1 kHz)
+#define PATTERN_SILENT        0xFFFFU       // CCR1 > ARR → bez tona
+
+// Jedan korak: točno redoslijed registara od ARR do CCR4 (DMA burst, 6 prijenosa)
+typedef struct {
+    uint16_t arr;     // perioda tona (ili pauze) − 1
+    uint16_t rcr;     // broj perioda u koraku − 1 (RCR je 8-bitni: najviše 256)
+    uint16_t ccr1;    // postavi PA12 (sredina periode) ili PATTERN_SILENT
+    uint16_t ccr2;    // obriši PA12 (kraj periode)
+    uint16_t ccr3;    // ne koristi se, samo popunjava burst
+    uint16_t ccr4;    // svjetlina LED-a (0 … arr + 1)
+} PatternStep;
+
+// Koraci za tablice: ton 'hz' u trajanju 'ms' (najviše 256 perioda) ili pauza od
+// 'ms' (najviše 256 ms), uz LED svjetline 'led' posto
+#define PATTERN_TONE(hz, ms, led) { \
+    (uint16_t)(PATTERN_TICK_HZ / (hz) - 1U), \
+    (uint16_t)((hz) * (ms) / 1000U - 1U), \
+    (uint16_t)(PATTERN_TICK_HZ / (hz) / 2U), \
+    (uint16_t)(PATTERN_TICK_HZ / (hz) - 1U), \
+    0, \
+    (uint16_t)((led) * (PATTERN_TICK_HZ / (hz)) / 100U) }
+
+#define PATTERN_REST(ms, led) { \
+    PATTERN_REST_ARR, \
+    (uint16_t)((ms) - 1U), \
+    PATTERN_SILENT, \
+    PATTERN_REST_ARR, \
+    0, \
+    (uint16_t)((led) * (PATTERN_REST_ARR + 1U) / 100U) }
+
+// Zadnji korak svake tablice: tišina i ugašen LED (nikad se ne odsvira do kraja)
+#define PATTERN_END           PATTERN_REST(1, 0)
+
+// Uzorci koje zna glavni program
+typedef enum {
+    PATTERN_OK = 0,       // točna lozinka
+    PATTERN_ERROR,        // pogrešna lozinka
+    PATTERN_LOCKOUT,      // previše grešaka → zaključano
+    PATTERN_CHANGED,      // lozinka promijenjena
+    PATTERN_COUNT
+} PatternId;
+
+// Prototipovi funkcija
+//
+// Pattern_Init()
+// - Preskaler TIM1 za PATTERN_TICK_HZ, LED i buzzer ugašeni
+//
+// Pattern_Play()
+// - Pokreće uzorak (prekida onaj koji trenutno svira), ne blokira
+//
+// Pattern_Stop()
+// - Odmah zaustavlja uzorak; LED se vraća na trajno stanje, buzzer se gasi
+//
+// Pattern_Led()
+// - Trajno stanje LED-a kad uzorak ne svira (1 = upaljen, npr. dok je otključano)
+//
+// Pattern_Poll()
+// - Poziva se iz glavne petlje: kad je timer stao na kraju uzorka, pospremi DMA
+//
+// Pattern_Busy()
+// - 1 dok uzorak svira (TIM1 radi, pa nema STOP-a ni promjene takta)
+//
+// Pattern_Retime()
+// - Ponovno izračuna preskaler nakon promjene takta APB2 (poziva ga clock.c)
+void Pattern_Init(void);
+void Pattern_Play(PatternId id);
+void Pattern_Stop(void);
+void Pattern_Led(uint8_t on);
+void Pattern_Poll(void);
+uint8_t Pattern_Busy(void);
+void Pattern_Retime(void);
+
+#endif // __PATTERN_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,229 @@
+#include "pin_store.h"   // Uključujemo header file s deklaracijama i HAL funkcijama
+#include <stddef.h>      // offsetof
+#include <string.h>      // memcpy, memcmp, memset
+
+// Raspored unutar sektora: zaglavlje, indeks (poravnat na 16 B), utori
+#define STORE_HDR_GEN     0U
+#define STORE_HDR_MAGIC   4U
+#define STORE_INDEX_OFS   16U
+#define STORE_REC_OFS     (STORE_INDEX_OFS + ((PIN_STORE_SLOTS + 15U) & ~15U))
+#define STORE_REC_WORDS   (sizeof(PinStoreRecord) / sizeof(uint32_t))
+#define STORE_FREE        0xFFU   // bajt indeksa: utor nije zauzet
+#define STORE_COMMITTED   0x00U   // bajt indeksa: zapis je potvrđen
+
+// Stanje drugog sektora
+#define STORE_SPARE_UNKNOWN 0U    // treba ga provjeriti (pokretanje, upravo napušten sektor)
+#define STORE_SPARE_BLANK   1U    // provjereno prazan
+#define STORE_SPARE_FAILED  2U    // brisanje nije uspjelo, pokušava se tek pri sažimanju
+
+_Static_assert(sizeof(PinStoreRecord) == 16, "PinStoreRecord mora biti 16 bajtova (4 riječi)");
+_Static_assert(STORE_REC_OFS + PIN_STORE_SLOTS * sizeof(PinStoreRecord) <= PIN_STORE_SECTOR_SIZE,
+               "PIN_STORE_SLOTS utora ne stane u sektor");
+
+// - Stanje pronađeno pri pokretanju (flash se poslije čita samo za usporedbu)
+static int8_t active = -1;    // sektor s većom generacijom (0 = A, 1 = B, -1 = nijedan)
+static uint32_t gen;          // generacija aktivnog sektora
+static uint16_t next;         // prvi slobodni utor u aktivnom sektoru
+static int16_t current = -1;  // utor s važećom lozinkom (-1 = nema spremljene)
+static uint8_t spare;         // stanje drugog sektora (cilj sažimanja), STORE_SPARE_*
+
+// - Adrese i brojevi sektora (FLASH_BASE u simulatoru nije konstanta pa su ovo funkcije)
+static uintptr_t store_base(uint8_t s) {
+    return s ? PIN_STORE_ADDR_B : PIN_STORE_ADDR_A;
+}
+
+static uint32_t store_sector(uint8_t s) {
+    return s ? PIN_STORE_SECTOR_B : PIN_STORE_SECTOR_A;
+}
+
+static uintptr_t store_slot(uint8_t s, uint16_t slot) {
+    return store_base(s) + STORE_REC_OFS + (uintptr_t)slot * sizeof(PinStoreRecord);
+}
+
+static uint8_t store_rd8(uintptr_t addr) {
+    return *(const volatile uint8_t *)addr;
+}
+
+static uint32_t store_rd32(uintptr_t addr) {
+    return *(const volatile uint32_t *)addr;
+}
+
+// - CRC-32 (IEEE, bez tablice: zapis ima samo 12 bajtova)
+static uint32_t store_crc(const uint8_t *p, uint32_t n) {
+    uint32_t crc = 0xFFFFFFFFU;
+    while (n--) {
+        crc ^= *p++;
+        for (uint32_t k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+// - Je li zapis u utoru cijel (duljina i CRC)
+static uint8_t store_record_ok(uint8_t s, uint16_t slot) {
+    PinStoreRecord rec;
+    memcpy(&rec, (const void *)store_slot(s, slot), sizeof(rec));
+    if (rec.len == 0 || rec.len > PIN_STORE_MAX_LEN) return 0;
+    return rec.crc == store_crc((const uint8_t *)&rec, offsetof(PinStoreRecord, crc));
+}
+
+// - Je li područje obrisano (sve 0xFF)
+static uint8_t store_blank(uintptr_t addr, uint32_t len) {
+    for (uint32_t i = 0; i < len; i += 4) {
+        if (store_rd32(addr + i) != 0xFFFFFFFFU) return 0;
+    }
+    return 1;
+}
+
+static uint8_t store_program(uint32_t type, uintptr_t addr, uint32_t data) {
+    return HAL_FLASH_Program(type, addr, data) == HAL_OK;
+}
+
+// - Upis zapisa u utor: zauzmi → upiši i provjeri → potvrdi
+// Vraća 0 ako utor nije upotrebljiv; tada ostaje zauzet (nepotvrđen) i preskače se.
+static uint8_t store_append(uint8_t s, uint16_t slot, const PinStoreRecord *rec) {
+    uintptr_t idx = store_base(s) + STORE_INDEX_OFS + slot;
+    uintptr_t addr = store_slot(s, slot);
+    uint32_t w[STORE_REC_WORDS];
+
+    if (store_rd8(idx) != STORE_FREE) return 0;
+    if (!store_program(FLASH_TYPEPROGRAM_BYTE, idx, PIN_STORE_CLAIMED)) return 0;
+    if (!store_blank(addr, sizeof(*rec))) return 0;   // ostaci prekinutog upisa
+
+    memcpy(w, rec, sizeof(w));
+    for (uint32_t i = 0; i < STORE_REC_WORDS; i++) {
+        if (!store_program(FLASH_TYPEPROGRAM_WORD, addr + i * 4U, w[i])) return 0;
+    }
+    if (memcmp((const void *)addr, rec, sizeof(*rec)) != 0) return 0;
+
+    return store_program(FLASH_TYPEPROGRAM_BYTE, idx, STORE_COMMITTED);
+}
+
+// - Drugi sektor (cilj sažimanja; dok lozinka nije spremljena, to je sektor A)
+static uint8_t store_spare(void) {
+    return (active < 0) ? 0 : (uint8_t)(active ^ 1);
+}
+
+// - Brisanje sektora (CPU stoji 1–2 s, vidi pin_store.h)
+static uint8_t store_erase(uint8_t s) {
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t bad_sector;
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Banks = FLASH_BANK_1;
+    erase.Sector = store_sector(s);
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;   // 2.7–3.6 V: brisanje po 32 bita
+    WRITE_REG(IWDG->KR, 0xAAAAU);                 // osvježi IWDG (ako radi): brisanje dobiva cijeli timeout
+    return HAL_FLASHEx_Erase(&erase, &bad_sector) == HAL_OK;
+}
+
+// - Sažimanje: upiši lozinku u prvi utor drugog sektora, pa zaglavlje
+// Drugi sektor je obično već obrisan (PinStore_Prepare); inače se briše ovdje.
+// Dok magic nije upisan, vrijedi stari sektor sa starom lozinkom.
+static uint8_t store_compact(const PinStoreRecord *rec) {
+    uint8_t t = store_spare();
+    uintptr_t base = store_base(t);
+    uint32_t g = (active < 0) ? 1U : gen + 1U;
+
+    if (spare != STORE_SPARE_BLANK && !store_blank(base, PIN_STORE_SECTOR_SIZE) && !store_erase(t)) return 0;
+    spare = STORE_SPARE_UNKNOWN;             // od sad se u njega upisuje (poslije je to stari sektor)
+
+    if (!store_append(t, 0, rec)) return 0;
+    if (!store_program(FLASH_TYPEPROGRAM_WORD, base + STORE_HDR_GEN, g)) return 0;
+    if (!store_program(FLASH_TYPEPROGRAM_WORD, base + STORE_HDR_MAGIC, PIN_STORE_MAGIC)) return 0;
+
+    active = (int8_t)t;
+    gen = g;
+    next = 1;
+    current = 0;
+    return 1;
+}
+
+// - Pokretanje: aktivni sektor je ispravan sektor s većom generacijom
+void PinStore_Init(void) {
+    active = -1;
+    current = -1;
+    next = 0;
+    spare = STORE_SPARE_UNKNOWN;             // drugi sektor se provjeri tek u PinStore_Prepare
+    for (uint8_t s = 0; s < 2; s++) {
+        uintptr_t base = store_base(s);
+        if (store_rd32(base + STORE_HDR_MAGIC) != PIN_STORE_MAGIC) continue;
+        uint32_t g = store_rd32(base + STORE_HDR_GEN);
+        if (active < 0 || (int32_t)(g - gen) > 0) {
+            active = (int8_t)s;
+            gen = g;
+        }
+    }
+    if (active < 0) return;                  // lozinka još nikad nije spremljena
+
+    // Utori se zauzimaju redom, pa je indeks niz zauzetih bajtova pa niz 0xFF:
+    // prvi slobodni utor se nađe binarnim pretraživanjem
+    uintptr_t idx = store_base((uint8_t)active) + STORE_INDEX_OFS;
+    uint32_t lo = 0, hi = PIN_STORE_SLOTS;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2U;
+        if (store_rd8(idx + mid) == STORE_FREE) hi = mid;
+        else lo = mid + 1U;
+    }
+    next = (uint16_t)lo;
+
+    // Važeća lozinka je zadnji potvrđeni utor (obično odmah prije slobodnog)
+    for (int32_t i = (int32_t)next - 1; i >= 0; i--) {
+        if (store_rd8(idx + (uint32_t)i) == STORE_COMMITTED && store_record_ok((uint8_t)active, (uint16_t)i)) {
+            current = (int16_t)i;
+            break;
+        }
+    }
+}
+
+uint8_t PinStore_Load(char *pin, uint8_t max) {
+    PinStoreRecord rec;
+    if (current < 0) return 0;
+    memcpy(&rec, (const void *)store_slot((uint8_t)active, (uint16_t)current), sizeof(rec));
+    if (rec.len > max) return 0;
+    memcpy(pin, rec.pin, rec.len);
+    pin[rec.len] = '\0';
+    return rec.len;
+}
+
+uint8_t PinStore_Save(const char *pin, uint8_t len) {
+    PinStoreRecord rec;
+    uint8_t ok = 0;
+    if (len == 0 || len > PIN_STORE_MAX_LEN) return 0;
+
+    memset(&rec, 0, sizeof(rec));
+    memcpy(rec.pin, pin, len);
+    rec.len = len;
+    memset(rec.rsvd, 0xFF, sizeof(rec.rsvd));
+    rec.crc = store_crc((const uint8_t *)&rec, offsetof(PinStoreRecord, crc));
+
+    // Ista lozinka je već spremljena → ništa se ne upisuje
+    if (current >= 0 &&
+        memcmp((const void *)store_slot((uint8_t)active, (uint16_t)current), &rec, sizeof(rec)) == 0) return 1;
+
+    HAL_FLASH_Unlock();
+    while (active >= 0 && next < PIN_STORE_SLOTS) {
+        uint16_t slot = next++;
+        if (store_append((uint8_t)active, slot, &rec)) {
+            current = (int16_t)slot;
+            ok = 1;
+            break;
+        }
+    }
+    if (!ok) ok = store_compact(&rec);       // sektor je pun (ili ga još nema)
+    HAL_FLASH_Lock();
+    return ok;
+}
+
+uint8_t PinStore_Prepare(void) {
+    uint8_t t = store_spare();
+    if (spare != STORE_SPARE_UNKNOWN) return 0;
+    spare = STORE_SPARE_BLANK;
+    if (!store_blank(store_base(t), PIN_STORE_SECTOR_SIZE)) {
+        HAL_FLASH_Unlock();
+        if (!store_erase(t)) spare = STORE_SPARE_FAILED;
+        HAL_FLASH_Lock();
+    }
+    return 1;
+}
@@ -0,0 +1,90 @@
+#ifndef __PIN_STORE_H__    // Ako __PIN_STORE_H__ nije već definiran...
+#define __PIN_STORE_H__    // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog HAL_FLASH funkcija i FLASH_BASE
+#include "stm32f4xx_hal.h"
+#include "flash_layout.h"
+
+// --- Trajna pohrana lozinke u flashu (dnevnik zapisa u dva sektora) ---
+// Promjena lozinke dopisuje jedan zapis i ne briše sektor. Kad se popune svi utori,
+// lozinka se sažme u drugi sektor, obrisan unaprijed. Svaki sektor izgleda ovako:
+//
+//   [zaglavlje 16 B][indeks: 1 bajt po utoru][utor 0][utor 1] … [utor N-1]
+//
+//   zaglavlje: generacija, pa tek onda magic (magic upisan = sektor je ispravan)
+//   indeks:    0xFF = slobodan, PIN_STORE_CLAIMED = zauzet (upis u tijeku ili
+//              prekinut), 0x00 = potvrđen; utori se zauzimaju redom
+//   utor:      lozinka, duljina i CRC-32 (PinStoreRecord)
+//
+// Upis ide u tri koraka: zauzmi bajt indeksa → upiši zapis → potvrdi bajt
+// indeksa. Flash na F4 nema ECC, pa se već upisani bajt smije ponovno upisati
+// ako se bitovi samo brišu (1 → 0), kao kod ST-ove emulacije EEPROM-a (AN3969).
+// Nestanak napajanja bilo kada ostavlja ili staru ili novu lozinku: nepotvrđeni
+// utor se preskače, a novi sektor vrijedi tek kad mu je magic upisan.
+//
+// Pri pokretanju se zadnji zauzeti utor nađe binarnim pretraživanjem indeksa
+// (najviše 13 čitanja za 7680 utora), bez čitanja cijelog dnevnika.
+//
+// Sektori su zadnja dva sektora flasha, izvedena iz čipa (flash_layout.h; na F401xE
+// sektori 6 i 7); provjera da kod ne seže do njih je u main.c (FLASH_APP_SIZE).
+//
+// Brisanje sektora od 128 KB traje tipično 1 s, najviše 2 s (datasheet F401, x32) i
+// cijelo to vrijeme zaustavlja CPU: kod i prekidi se izvršavaju iz flasha, pa stoje
+// SysTick, skeniranje tipkovnice, scheduler i LCD. Na F4 se brisanje sektora ne može
+// razlomiti na dijelove, pa se drugi sektor briše unaprijed, dok brava miruje
+// (PinStore_Prepare), a ne kad se sektor popuni usred promjene lozinke. Prije brisanja
+// se osvježi IWDG; ako se watchdog uključi, timeout mu mora biti dulji od
+// PIN_STORE_ERASE_MAX_MS.
+
+#define PIN_STORE_SECTOR_A     FLASH_PIN_SECTOR_A
+#define PIN_STORE_SECTOR_B     FLASH_PIN_SECTOR_B
+#define PIN_STORE_OFS_A        FLASH_LAYOUT_OFS(PIN_STORE_SECTOR_A)   // pomak od FLASH_BASE
+#define PIN_STORE_OFS_B        FLASH_LAYOUT_OFS(PIN_STORE_SECTOR_B)
+#define PIN_STORE_ADDR_A       (FLASH_BASE + PIN_STORE_OFS_A)
+#define PIN_STORE_ADDR_B       (FLASH_BASE + PIN_STORE_OFS_B)
+#define PIN_STORE_SECTOR_SIZE  FLASH_LAYOUT_SIZE(PIN_STORE_SECTOR_A)  // 128 KB
+#define PIN_STORE_ERASE_MAX_MS 2000U            // najdulje brisanje sektora od 128 KB (tipično 1000)
+
+// Broj utora po sektoru (16 + 7680 + 7680 × 16 = 130576 B ≤ 128 KB)
+#ifndef PIN_STORE_SLOTS
+#define PIN_STORE_SLOTS        7680U
+#endif
+
+#define PIN_STORE_MAX_LEN      8U               // najdulja lozinka koja stane u zapis
+#define PIN_STORE_MAGIC        0x50494E31U      // "PIN1"
+#define PIN_STORE_CLAIMED      0x7FU            // bajt indeksa: utor zauzet, zapis nije potvrđen
+
+// Jedan zapis (utor), upisuje se riječ po riječ
+typedef struct {
+    char pin[PIN_STORE_MAX_LEN];   // znakovi lozinke, ostatak 0
+    uint8_t len;                   // duljina lozinke (1 … PIN_STORE_MAX_LEN)
+    uint8_t rsvd[3];               // 0xFF (neupisano)
+    uint32_t crc;                  // CRC-32 prethodnih 12 bajtova
+} PinStoreRecord;
+
+// Prototipovi funkcija
+//
+// PinStore_Init()
+// - Pri pokretanju: odabere važeći sektor (veća generacija) i nađe zadnji potvrđeni zapis
+//
+// PinStore_Load()
+// - Kopira spremljenu lozinku u pin (max znakova + '\0'), vraća njenu duljinu
+// - Vraća 0 ako lozinka još nije spremljena (koristi se tvornička)
+//
+// PinStore_Save()
+// - Dopisuje novu lozinku (blokira dok flash upisuje, oko 100 µs); kad je sektor
+//   pun, sažima u drugi sektor (oko 300 µs ako ga je PinStore_Prepare već obrisao,
+//   inače i brisanje: 1–2 s)
+// - Vraća 1 kad je lozinka trajno spremljena, 0 ako flash nije uspio
+//
+// PinStore_Prepare()
+// - Poziva se kad brava miruje: jednom nakon pokretanja i nakon svakog sažimanja provjeri
+//   drugi sektor i obriše ga ako nije prazan (blokira 1–2 s), pa sažimanje ne briše;
+//   inače se odmah vraća (ako brisanje ne uspije, briše se tek pri sažimanju)
+// - Vraća 1 ako je radio s flashem (prošlo je vrijeme), 0 ako nije imao što raditi
+void PinStore_Init(void);
+uint8_t PinStore_Load(char *pin, uint8_t max);
+uint8_t PinStore_Save(const char *pin, uint8_t len);
+uint8_t PinStore_Prepare(void);
+
+#endif // __PIN_STORE_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,92 @@
+#include "power.h"    // Uključujemo header file s deklaracijama i HAL funkcijama
+#include "main.h"     // SystemClock_Config() za povratak takta nakon STOP-a
+
+// EXTI linija tipkala PC13
+#define POWER_RESET_MASK  (1u << POWER_RESET_LINE)
+
+static PowerStats stats;
+static Keypad *wake_keypads[POWER_MAX_KEYPADS];  // tipkovnice koje se parkiraju i bude iz STOP-a
+static uint8_t wake_count;
+static uint32_t col_lines;                        // EXTI linije kolona svih tipkovnica
+static uint32_t wake_lines;                       // kolone + PC13
+
+// - Spoji EXTI liniju na port (SYSCFG_EXTICR: 4 linije po registru, 4 bita po liniji)
+static void power_exti_map(uint32_t line, uint32_t port) {
+    uint32_t shift = (line & 3u) * 4u;
+    SYSCFG->EXTICR[line >> 2] = (SYSCFG->EXTICR[line >> 2] & ~(0xFu << shift)) | (port << shift);
+}
+
+// - Inicijalizacija EXTI linija (događaji ostaju maskirani do ulaska u STOP)
+void Power_Init(Keypad *const *keypads, uint8_t count) {
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+    wake_count = 0;
+    col_lines = 0;
+    for (uint8_t i = 0; i < count && wake_count < POWER_MAX_KEYPADS; i++) {
+        const KeypadPins *pins = keypads[i]->pins;
+        uint32_t lines = keypads[i]->col_pins;          // pin n je EXTI linija n
+        if (lines & (col_lines | POWER_RESET_MASK)) continue;   // linija je već zauzeta
+
+        for (uint32_t c = 0; c < KEYPAD_COLS; c++) {
+            power_exti_map(pins->col_shift + c, pins->exti_port);
+        }
+        col_lines |= lines;
+        wake_keypads[wake_count++] = keypads[i];
+    }
+    power_exti_map(POWER_RESET_LINE, POWER_RESET_EXTI);
+    wake_lines = col_lines | POWER_RESET_MASK;
+
+    EXTI->IMR &= ~wake_lines;                // bez prekida, budimo se samo događajem
+    EXTI->EMR &= ~wake_lines;
+    EXTI->RTSR |= col_lines;                 // pritisak tipke: kolona LOW → HIGH
+    EXTI->FTSR &= ~col_lines;
+    EXTI->FTSR |= POWER_RESET_MASK;          // tipkalo PC13: HIGH → LOW
+    EXTI->RTSR &= ~POWER_RESET_MASK;
+}
+
+// - Je li tipka ili tipkalo aktivno (tada ne bi bilo brida koji budi)
+static uint8_t power_wake_active(void) {
+    for (uint8_t i = 0; i < wake_count; i++) {
+        if (READ_REG(wake_keypads[i]->pins->port->IDR) & wake_keypads[i]->col_pins) return 1;
+    }
+    if (!(READ_REG(POWER_RESET_PORT->IDR) & POWER_RESET_MASK)) return 2;
+    return 0;
+}
+
+// - Mirovanje na kraju prolaza glavne petlje
+void Power_Idle(uint8_t can_stop) {
+    if (!can_stop) {
+        stats.sleep_count++;
+        HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);   // do sljedećeg prekida
+        return;
+    }
+
+    HAL_SuspendTick();                       // bez SysTicka: nema skeniranja ni buđenja svake 1 ms
+    for (uint8_t i = 0; i < wake_count; i++) {
+        Keypad_Park(wake_keypads[i]);        // svi redovi HIGH
+    }
+    EXTI->PR = wake_lines;
+    EXTI->EMR |= wake_lines;                 // od sada svaki brid budi (i onaj prije WFE)
+
+    if (power_wake_active()) {               // tipka je već dolje → ne bi bilo brida, ostani budan
+        stats.stop_aborted++;
+    } else {
+        stats.stop_count++;
+        HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFE);
+        SystemClock_Config();                // STOP se budi na HSI → vrati konfigurirani takt
+
+        uint8_t src = power_wake_active();
+        if (src == 1) stats.wake_keypad++;
+        else if (src == 2) stats.wake_reset++;
+    }
+
+    EXTI->EMR &= ~wake_lines;
+    for (uint8_t i = 0; i < wake_count; i++) {
+        Keypad_Resume(wake_keypads[i]);      // redovi LOW, tipka koja je probudila se očita u
+    }
+    HAL_ResumeTick();                        // sljedećem SysTicku i normalno prolazi debounce
+}
+
+const PowerStats *Power_GetStats(void) {
+    return &stats;
+}
@@ -0,0 +1,57 @@
+#ifndef __POWER_H__        // Ako __POWER_H__ nije već definiran...
+#define __POWER_H__        // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog EXTI, SYSCFG i HAL_PWR funkcija
+#include "stm32f4xx_hal.h"
+
+// Tipkovnice koje bude iz STOP-a (Keypad, KeypadPins)
+#include "keypad.h"
+
+// --- Niska potrošnja u mirovanju ---
+// Dok nešto radi (timeri, LCD, UART, pritisnuta tipka) glavna petlja spava u Sleep
+// modu (WFI) do sljedećeg prekida, a SysTick i dalje skenira tipkovnicu svake 1 ms.
+// Kad sve miruje, SysTick se zaustavi, redovi tipkovnice se podignu, EXTI se
+// naoruža na kolonama i na PC13, a procesor ide u STOP dok se ne pritisne tipka.
+// Buđenje je preko EXTI događaja (WFE), pa ne trebaju EXTI prekidne rutine.
+//
+// U STOP-u HAL_GetTick() stoji, pa periodički timeri nastavljaju kao da je
+// vrijeme stalo, a jednokratnih timera tada ionako nema.
+
+// EXTI linija i kod porta (SYSCFG_EXTICR: 0 = GPIOA, 1 = GPIOB, 2 = GPIOC) za tipkalo PC13
+#define POWER_RESET_LINE     13
+#define POWER_RESET_PORT     GPIOC
+#define POWER_RESET_EXTI     2u
+
+// Najviše tipkovnica koje bude iz STOP-a (kod svake su kolone EXTI linije
+// col_shift.., a port je KeypadPins.exti_port)
+#define POWER_MAX_KEYPADS    4
+
+// Brojači prijelaza (za izvještaj o udjelu vremena u mirovanju)
+typedef struct {
+    uint32_t sleep_count;      // ulazaka u Sleep (WFI)
+    uint32_t stop_count;       // ulazaka u STOP
+    uint32_t stop_aborted;     // STOP otkazan jer je tipka ili tipkalo već bilo aktivno
+    uint32_t wake_keypad;      // buđenja iz STOP-a tipkovnicom
+    uint32_t wake_reset;       // buđenja iz STOP-a tipkalom PC13
+} PowerStats;
+
+// Prototipovi funkcija
+//
+// Power_Init()
+// - Spaja EXTI linije kolona svih tipkovnica (rastući brid) i PC13 (padajući brid),
+//   događaji ostaju maskirani
+// - Tipkovnica čije se kolone preklapaju s već spojenom (ili s PC13) se preskače:
+//   jedna EXTI linija može biti spojena samo na jedan port
+//
+// Power_Idle()
+// - Poziva se na kraju svakog prolaza glavne petlje
+// - can_stop = 0 → Sleep do sljedećeg prekida (SysTick, DMA)
+// - can_stop = 1 → STOP do pritiska tipke ili tipkala; nakon buđenja vraća
+//   sistemski takt (SystemClock_Config), redove svih tipkovnica i SysTick
+//
+// Power_GetStats() - vraća pokazivač na brojače
+void Power_Init(Keypad *const *keypads, uint8_t count);
+void Power_Idle(uint8_t can_stop);
+const PowerStats *Power_GetStats(void);
+
+#endif // __POWER_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,89 @@
+#include "prof.h"    // Uključujemo header file s deklaracijama i HAL funkcijama
+
+#if PROF_ENABLE
+
+#include "audit.h"   // statistika se šalje kao zapisi dnevnika pristupa
+
+// - Statistika svih sondi
+static ProfStat prof[PROF_COUNT];
+
+// - Stanje slanja: sonda i polje koje je sljedeće na redu
+// Polja jedne sonde: 0 = broj, 1 = min, 2 = max, 3 = srednja vrijednost, 4+i = pretinac i
+#define PROF_FIELD_HIST   4
+#define PROF_FIELDS       (PROF_FIELD_HIST + PROF_HIST_BUCKETS)
+static uint8_t dump_probe = PROF_COUNT;   // PROF_COUNT = slanje nije u tijeku
+static uint8_t dump_field;
+
+_Static_assert(PROF_COUNT <= 8 && PROF_FIELDS <= 32, "sonda i polje moraju stati u jedan bajt (3 + 5 bitova)");
+
+// - Inicijalizacija: uključi brojač ciklusa i obriši statistiku
+void Prof_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   // uključi DWT blok
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;              // pokreni brojač ciklusa
+
+    for (int i = 0; i < PROF_COUNT; i++) {
+        ProfStat *s = &prof[i];
+        s->count = 0;
+        s->min = 0xFFFFFFFFu;
+        s->max = 0;
+        s->sum = 0;
+        for (int b = 0; b < PROF_HIST_BUCKETS; b++) s->hist[b] = 0;
+    }
+    dump_probe = PROF_COUNT;
+}
+
+// - Jedno mjerenje: min/max/zbroj i pretinac histograma preko CLZ
+void Prof_Add(ProfProbe p, uint32_t cycles) {
+    ProfStat *s = &prof[p];
+    s->count++;
+    s->sum += cycles;
+    if (cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+
+    int32_t b = (31 - (int32_t)__CLZ(cycles | 1u)) - PROF_HIST_SHIFT;   // log2(cycles) - pomak
+    if (b < 0) b = 0;
+    if (b > PROF_HIST_BUCKETS - 1) b = PROF_HIST_BUCKETS - 1;
+    s->hist[b]++;
+}
+
+const ProfStat *Prof_Get(ProfProbe p) {
+    return &prof[p];
+}
+
+// - Pokreni slanje statistike (npr. na servisni akord)
+void Prof_DumpStart(void) {
+    dump_probe = 0;
+    dump_field = 0;
+}
+
+// - Vrijednost polja sonde; vraća 0 za polja koja se ne šalju (prazni pretinci)
+static uint8_t prof_field(const ProfStat *s, uint8_t field, uint32_t *value) {
+    switch (field) {
+    case 0: *value = s->count; return 1;
+    case 1: *value = s->min;   return 1;
+    case 2: *value = s->max;   return 1;
+    case 3: *value = (uint32_t)(s->sum / s->count); return 1;
+    default:
+        *value = s->hist[field - PROF_FIELD_HIST];
+        return *value != 0;
+    }
+}
+
+// - Slanje statistike zapis po zapis (glavna petlja)
+// Koristi najviše tri četvrtine dnevnika, ostatak ostaje za prave događaje.
+void Prof_Poll(void) {
+    while (dump_probe < PROF_COUNT && Audit_Free() > AUDIT_LOG_SIZE / 4) {
+        const ProfStat *s = &prof[dump_probe];
+        uint32_t value;
+        if (s->count && prof_field(s, dump_field, &value)) {
+            Audit_RecordValue(AUDIT_EV_PROF, (uint8_t)((dump_probe << 5) | dump_field), value);
+        }
+        if (s->count == 0 || ++dump_field == PROF_FIELDS) {   // sonda gotova → sljedeća
+            dump_field = 0;
+            dump_probe++;
+        }
+    }
+}
+
+#endif // PROF_ENABLE
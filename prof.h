@@ -0,0 +1,88 @@
+#ifndef __PROF_H__         // Ako __PROF_H__ nije već definiran...
+#define __PROF_H__         // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog DWT, CoreDebug, READ_REG i __CLZ
+#include "stm32f4xx_hal.h"
+
+// --- Mjerenje vremena kritičnih dijelova koda (profiliranje) ---
+// Uključuje se s -DPROF_ENABLE=1. Kad je isključeno, sve PROF_* i Prof_* oznake
+// se prevedu u ništa: nema varijabli, poziva ni čitanja brojača.
+//
+// Vrijeme se mjeri u ciklusima procesora iz DWT->CYCCNT. U simulatoru isti
+// registar vraća virtualni brojač ciklusa izveden iz virtualnog sata; prekidi
+// tamo traju 0 ciklusa, pa za sondu SCAN benchmark ispisuje samo broj mjerenja.
+#ifndef PROF_ENABLE
+#define PROF_ENABLE 0
+#endif
+
+// Mjerna mjesta (sonde). Svaku sondu smije mjeriti samo jedan kontekst
+// (glavna petlja ili jedan prekid), pa statistika ne treba zaštitu.
+typedef enum {
+    PROF_LOOP = 0,       // jedan krug glavne petlje
+    PROF_SCHED,          // Sched_Run()
+    PROF_KEYS,           // obrada događaja s tipkovnice i automat brave
+    PROF_SCAN,           // Keypad_ScanTick() u SysTick prekidu
+    PROF_LCD_QUEUE,      // jedan bajt (naredba ili znak) u I2C buffer LCD-a
+    PROF_LCD_FLUSH,      // lcd_i2c_flush()
+    PROF_LCD_WAIT,       // čekanje da I2C prijenos prema LCD-u završi
+    PROF_AUDIT,          // Audit_Poll()
+    PROF_COUNT
+} ProfProbe;
+
+// Imena sondi istim redom (za ispis na računalu)
+#define PROF_PROBE_NAMES { "loop", "sched", "keys", "scan", "lcd_queue", "lcd_flush", "lcd_wait", "audit" }
+
+// Histogram: pretinac i broji trajanja od 2^(i+PROF_HIST_SHIFT) do 2^(i+PROF_HIST_SHIFT+1) ciklusa,
+// prvi pretinac sve kraće, zadnji sve duže
+#define PROF_HIST_BUCKETS  16
+#define PROF_HIST_SHIFT    4
+
+// Statistika jedne sonde (u ciklusima)
+typedef struct {
+    uint32_t count;                        // broj mjerenja
+    uint32_t min;                          // najkraće trajanje
+    uint32_t max;                          // najduže trajanje
+    uint64_t sum;                          // zbroj trajanja (za srednju vrijednost)
+    uint32_t hist[PROF_HIST_BUCKETS];      // log2 histogram trajanja
+} ProfStat;
+
+#if PROF_ENABLE
+
+#define PROF_CYCLES()  READ_REG(DWT->CYCCNT)
+
+// PROF_BEGIN(LOOP) ... PROF_END(LOOP) mjeri kod između, u istom bloku
+#define PROF_BEGIN(p)  uint32_t prof_t0_##p = PROF_CYCLES()
+#define PROF_END(p)    Prof_Add(PROF_##p, PROF_CYCLES() - prof_t0_##p)
+
+// Prototipovi funkcija za profiliranje
+//
+// Prof_Init()
+// - Uključuje DWT brojač ciklusa i briše statistiku
+//
+// Prof_Add()
+// - Dodaje jedno mjerenje u statistiku sonde (zovu ga PROF_END makroi)
+//
+// Prof_Get()
+// - Vraća statistiku sonde (samo za čitanje)
+//
+// Prof_DumpStart() / Prof_Poll()
+// - Pokreće slanje statistike kao AUDIT_EV_PROF zapisa kroz dnevnik pristupa;
+//   Prof_Poll() iz glavne petlje šalje zapis po zapis dok u dnevniku ima mjesta,
+//   pa slanje nikad ne istiskuje prave zapise o pristupu
+void Prof_Init(void);
+void Prof_Add(ProfProbe p, uint32_t cycles);
+const ProfStat *Prof_Get(ProfProbe p);
+void Prof_DumpStart(void);
+void Prof_Poll(void);
+
+#else
+
+#define PROF_BEGIN(p)     do { } while (0)
+#define PROF_END(p)       do { } while (0)
+#define Prof_Init()       ((void)0)
+#define Prof_DumpStart()  ((void)0)
+#define Prof_Poll()       ((void)0)
+
+#endif // PROF_ENABLE
+
+#endif // __PROF_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,97 @@
+#include "sched.h"   // Deklaracije schedulera
+
+// --- Jedan timer ---
+typedef struct {
+    SchedFn fn;          // funkcija koja se poziva (NULL = mjesto je slobodno)
+    void *arg;           // argument za funkciju
+    uint32_t due;        // HAL_GetTick() kada timer dospijeva
+    uint32_t period;     // period u ms (0 = jednokratni timer)
+} SchedTimer;
+
+static SchedTimer timers[SCHED_MAX_TIMERS];  // svi timeri
+static SchedStats stats;                      // statistika odziva
+static uint32_t last_run;                     // HAL_GetTick() prethodnog Sched_Run() poziva
+static uint8_t last_run_valid;                // 0 dok Sched_Run() još nije pozvan
+
+// --- Pronađi timer za par (fn, arg), vraća NULL ako ne postoji ---
+static SchedTimer *sched_find(SchedFn fn, void *arg) {
+    for (int i = 0; i < SCHED_MAX_TIMERS; i++) {
+        if (timers[i].fn == fn && timers[i].arg == arg) return &timers[i];
+    }
+    return 0;
+}
+
+// --- Pokreni (ili ponovno pokreni) timer ---
+uint8_t Sched_Start(SchedFn fn, void *arg, uint32_t delay_ms, uint32_t period_ms) {
+    SchedTimer *t = sched_find(fn, arg);      // isti timer već postoji → samo novo vrijeme
+    if (!t) t = sched_find(0, 0);             // inače uzmi prvo slobodno mjesto
+    if (!t) return 0;                         // nema mjesta
+
+    t->due = HAL_GetTick() + delay_ms;
+    t->period = period_ms;
+    t->arg = arg;
+    t->fn = fn;
+    return 1;
+}
+
+// --- Zaustavi timer ---
+void Sched_Cancel(SchedFn fn, void *arg) {
+    SchedTimer *t = sched_find(fn, arg);
+    if (t) {
+        t->fn = 0;
+        t->arg = 0;
+    }
+}
+
+// --- Je li timer aktivan? ---
+uint8_t Sched_Pending(SchedFn fn, void *arg) {
+    return sched_find(fn, arg) != 0;
+}
+
+// --- Nema li aktivnih jednokratnih timera? ---
+uint8_t Sched_Idle(void) {
+    for (int i = 0; i < SCHED_MAX_TIMERS; i++) {
+        if (timers[i].fn && timers[i].period == 0) return 0;
+    }
+    return 1;
+}
+
+// --- Pokreni sve dospjele timere ---
+void Sched_Run(void) {
+    uint32_t now = HAL_GetTick();
+
+    // Mjerenje trajanja jednog prolaza petlje
+    if (last_run_valid && now - last_run > stats.loop_max_ms) {
+        stats.loop_max_ms = now - last_run;
+    }
+    last_run = now;
+    last_run_valid = 1;
+
+    for (int i = 0; i < SCHED_MAX_TIMERS; i++) {
+        SchedTimer *t = &timers[i];
+        if (!t->fn || (int32_t)(now - t->due) < 0) continue;  // slobodno ili još nije vrijeme
+
+        SchedFn fn = t->fn;
+        void *arg = t->arg;
+        if (t->period) {
+            t->due += t->period;              // periodički → sljedeći termin
+        } else {
+            t->fn = 0;                        // jednokratni → oslobodi mjesto prije poziva
+            t->arg = 0;                       // (funkcija ga smije ponovno pokrenuti)
+        }
+        fn(arg);
+    }
+}
+
+// --- Zabilježi kašnjenje ulaznog događaja ---
+void Sched_InputLatency(uint32_t event_tick) {
+    uint32_t lat = HAL_GetTick() - event_tick;
+    if (lat > stats.input_max_ms) stats.input_max_ms = lat;
+    stats.input_sum_ms += lat;
+    stats.input_count++;
+}
+
+// --- Statistika odziva ---
+const SchedStats *Sched_GetStats(void) {
+    return &stats;
+}
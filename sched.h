@@ -0,0 +1,52 @@
+#ifndef __SCHED_H__        // Ako __SCHED_H__ nije već definiran...
+#define __SCHED_H__        // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog HAL_GetTick() i tipova uint32_t/uint8_t
+#include "stm32f4xx_hal.h"
+
+// --- Jednostavni kooperativni scheduler na HAL_GetTick() (SysTick, 1 ms) ---
+// Umjesto HAL_Delay-a, funkcija se zakaže da se izvrši za N ms (jednom ili periodički).
+// Sched_Run() se poziva u svakom prolazu glavne petlje i pokreće timere koji su dospjeli,
+// pa petlja nikad ne stoji i uvijek stigne pročitati tipkovnicu i tipkalo.
+
+// Najveći broj istodobno aktivnih timera
+#define SCHED_MAX_TIMERS  8
+
+// Funkcija koju timer poziva (arg je isti pokazivač koji je predan kod pokretanja)
+typedef void (*SchedFn)(void *arg);
+
+// Statistika odziva (u ms, mjereno s HAL_GetTick())
+typedef struct {
+    uint32_t loop_max_ms;      // najduži razmak između dva poziva Sched_Run() (jedan prolaz petlje)
+    uint32_t input_max_ms;     // najduže kašnjenje od događaja na ulazu do njegove obrade
+    uint32_t input_count;      // broj obrađenih ulaznih događaja
+    uint32_t input_sum_ms;     // zbroj kašnjenja (prosjek = input_sum_ms / input_count)
+} SchedStats;
+
+// Prototipovi funkcija
+//
+// Sched_Start()
+// - (Ponovno) pokreće timer za par (fn, arg): prvi poziv za delay_ms,
+//   zatim svakih period_ms (period_ms = 0 → timer se izvrši samo jednom)
+// - Ako timer s istim (fn, arg) već postoji, samo mu se postavi novo vrijeme
+// - Vraća 1 ako je timer pokrenut, 0 ako nema slobodnog mjesta
+//
+// Sched_Cancel()  - zaustavlja timer (fn, arg) ako postoji
+// Sched_Pending() - vraća 1 ako je timer (fn, arg) aktivan
+// Sched_Run()     - pokreće sve dospjele timere (poziva se iz glavne petlje)
+// Sched_Idle()    - vraća 1 ako nema aktivnih jednokratnih timera; periodički timeri
+//                   smiju stati zajedno sa SysTickom (npr. u STOP modu) i nastaviti poslije
+//
+// Sched_InputLatency()
+// - Bilježi kašnjenje ulaznog događaja: event_tick je HAL_GetTick() u trenutku događaja
+//
+// Sched_GetStats() - vraća pokazivač na statistiku odziva
+uint8_t Sched_Start(SchedFn fn, void *arg, uint32_t delay_ms, uint32_t period_ms);
+void Sched_Cancel(SchedFn fn, void *arg);
+uint8_t Sched_Pending(SchedFn fn, void *arg);
+void Sched_Run(void);
+uint8_t Sched_Idle(void);
+void Sched_InputLatency(uint32_t event_tick);
+const SchedStats *Sched_GetStats(void);
+
+#endif // __SCHED_H__   // završetak zaštite od višestrukog uključivanja
@@ -0,0 +1,300 @@
+#include "sim.h"
+#include "audit.h"
+#include "prof.h"
+#include "cred.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// --- Benchmark firmware-a u simulatoru ---
+// main.c, keypad.c i lcd_i2c.c se prevode nepromijenjeni (main → firmware_main)
+// i vrte se na virtualnom satu. Za svaki scenarij ispisuje se promet na I2C
+// sabirnici, vrijeme zauzeća sabirnice, kašnjenje od pritiska tipke do piksela
+// broj zapisa dnevnika pristupa koji su stigli preko UART-a te udio vremena u
+// kojem procesor nije spavao, udio vremena u STOP modu i na brzom taktu (PLL) te
+// koliko je dugo svijetlio LED i svirao buzzer (uzorci na TIM1 + DMA) te broj
+// upisa i brisanja flasha (pohrana lozinke i tablica korisnika) i broj ikona
+// učitanih u CGRAM LCD-a i vrijeme od reseta do poruke "Upisi lozinku:".
+// Svaki scenarij se izvodi u zasebnom procesu (fork) da statičko stanje firmware-a
+// uvijek kreće od nule, kao nakon reseta. Scenarij s ponovnim paljenjem prvi dio
+// izvodi u još jednom procesu; flash je dijeljen pa drugi dio kreće od onoga što je
+// prvi upisao (i eventualno prekinuo nestankom napajanja). Kod toplog reseta
+// (watchdog) i LCD zadržava stanje, pa firmware preskače njegov reset slijed.
+
+#define LCD_ADDR   0x27
+#define HOLD_MS    80      // koliko dugo se drži tipka
+#define GAP_MS     300     // razmak između pritisaka
+#define BOOT_MS    300     // prvi pritisak nakon pokretanja
+#define PROMPT     "Upisi lozinku:"   // početna poruka (kraj pokretanja)
+
+int firmware_main(void);
+
+typedef struct {
+    const char *name;             // ime scenarija
+    uint32_t (*script)(void);     // postavlja skriptu, vraća trajanje scenarija (ms)
+    const char *expect0;          // očekivani prvi red zaslona na kraju
+    const char *expect1;          // očekivani drugi red (0 = ne provjerava se)
+    uint32_t expect_audit;        // očekivani broj zapisa dnevnika poslanih preko UART-a
+    uint32_t expect_patterns;     // očekivani broj odsviranih uzoraka LED/buzzer
+    uint32_t (*reboot)(void);     // skripta nakon ponovnog paljenja (0 = bez njega); provjere
+                                  // i statistika odnose se na ovaj dio
+    uint32_t cut_op;              // prije paljenja nestaje napajanja na ovoj operaciji flasha (0 = ne)
+    int (*setup)(void);           // umjesto prvog paljenja (npr. upis tablice korisnika; 0 = firmware)
+    int warm;                     // reboot je reset procesora bez nestanka napajanja (watchdog)
+} Scenario;
+
+// Ispravan PIN: 1234
+static uint32_t sc_correct(void) {
+    uint32_t t = sim_script_keys(BOOT_MS, "1234", HOLD_MS, GAP_MS);
+    return t + 1500;
+}
+
+// Tri puta pogrešan PIN → zaključavanje
+static uint32_t sc_lockout(void) {
+    uint32_t t = BOOT_MS;
+    for (int i = 0; i < 3; i++) {
+        t = sim_script_keys(t, "1111", HOLD_MS, GAP_MS) + 1500;
+    }
+    return t + 1500;
+}
+
+// Promjena lozinke (otključaj s 1234, pa #5678) i otključavanje novom lozinkom
+static uint32_t sc_change(void) {
+    uint32_t t = sim_script_keys(BOOT_MS, "1234#5678", HOLD_MS, GAP_MS);
+    t = sim_script_keys(t + 1500, "5678", HOLD_MS, GAP_MS);
+    return t + 1500;
+}
+
+// Nakon ponovnog paljenja vrijedi lozinka 5678
+static uint32_t sc_unlock_5678(void) {
+    return sim_script_keys(BOOT_MS, "5678", HOLD_MS, GAP_MS) + 1500;
+}
+
+// Dvije promjene lozinke (5678 pa 4321); druga se prekida nestankom napajanja
+static uint32_t sc_change_twice(void) {
+    uint32_t t = sim_script_keys(BOOT_MS, "1234#5678", HOLD_MS, GAP_MS);
+    t = sim_script_keys(t + 1500, "5678#4321", HOLD_MS, GAP_MS);
+    return t + 1500;
+}
+
+// Devet promjena lozinke (1111 … 9999), svaka nakon otključavanja prethodnom:
+// s 4 utora po sektoru dvaput se sažima, a drugo sažimanje briše sektor A
+static uint32_t sc_change_many(void) {
+    uint32_t t = BOOT_MS;
+    char keys[10] = "1234#0000";
+    for (char d = '1'; d <= '9'; d++) {
+        memset(keys + 5, d, 4);
+        t = sim_script_keys(t, keys, HOLD_MS, GAP_MS) + 1500;
+        memset(keys, d, 4);
+    }
+    return t;
+}
+
+static uint32_t sc_unlock_9999(void) {
+    return sim_script_keys(BOOT_MS, "9999", HOLD_MS, GAP_MS) + 1500;
+}
+
+static uint32_t sc_unlock_8888(void) {
+    return sim_script_keys(BOOT_MS, "8888", HOLD_MS, GAP_MS) + 1500;
+}
+
+// Četiri tipke u pravokutniku (uzorak duha) pa servisni akord *+#
+// Uzorak ne smije ništa upisati, a servisni zaslon ga mora izbrojati
+static uint32_t sc_chord(void) {
+    uint32_t t = BOOT_MS;
+    sim_script_key(t, '1', 300);
+    sim_script_key(t, '2', 300);
+    sim_script_key(t, '4', 300);
+    sim_script_key(t + 20, '5', 280);
+    t += 600;
+    sim_script_key(t, '*', 1300);
+    sim_script_key(t + 100, '#', 1200);
+    return t + 1500;
+}
+
+// Tablica korisnika: BENCH_USERS slučajnih lozinaka od 4–8 znamenki, uz njih
+// poznate lozinke sa slovima (ne mogu se poklopiti sa slučajnima)
+#define BENCH_USERS 3000
+
+static uint8_t bench_user_pin(uint32_t i, char *pin) {
+    uint32_t x = i * 2654435761U + 12345U;
+    uint8_t len = (uint8_t)(CRED_PIN_MIN + i % (CRED_PIN_MAX - CRED_PIN_MIN + 1));
+    for (uint8_t k = 0; k < len; k++) {
+        x = x * 1103515245U + 12345U;
+        pin[k] = (char)('0' + (x >> 16) % 10);
+    }
+    pin[len] = '\0';
+    return len;
+}
+
+static int setup_users(void) {
+    char pin[CRED_PIN_MAX + 1];
+    uint32_t added = 0;
+    Cred_Init();
+    for (uint32_t i = 0; i < BENCH_USERS; i++) {
+        uint8_t len = bench_user_pin(i, pin);
+        added += Cred_Add(pin, len, CRED_ROLE_USER);
+    }
+    Cred_Add("13A79", 5, CRED_ROLE_USER);
+    Cred_Add("2468AC", 6, CRED_ROLE_ADMIN);
+    Cred_Add("8B42", 4, CRED_ROLE_ONCE);
+    Cred_Add("97C31", 5, CRED_ROLE_USER);
+    Cred_Revoke("97C31", 5);
+    printf("    korisnika: %u/%u (%u utora)\n", added, BENCH_USERS, CRED_SLOTS);
+    fflush(stdout);
+    return 0;
+}
+
+// Jednokratna lozinka vrijedi samo prvi put, opozvana nikad; kraće od najdulje
+// lozinke predaju se tipkom D. Na kraju zadnji slučajni korisnik.
+static uint32_t sc_users(void) {
+    static const char *const seq[] = { "8B42D*", "8B42D", "97C31D", "13A79D*", "2468ACD*", "1234D*" };
+    char keys[CRED_PIN_MAX + 2];
+    uint32_t t = BOOT_MS;
+    for (size_t i = 0; i < sizeof(seq) / sizeof(seq[0]); i++) {
+        t = sim_script_keys(t, seq[i], HOLD_MS, GAP_MS) + 1500;
+    }
+    uint8_t len = bench_user_pin(BENCH_USERS - 1, keys);
+    if (len < CRED_PIN_MAX) strcat(keys, "D");
+    return sim_script_keys(t, keys, HOLD_MS, GAP_MS) + 1500;
+}
+
+// Vrijeme za upis tablice (setup se vrati čim završi)
+static uint32_t sc_setup(void) {
+    return 60000;
+}
+
+static const Scenario scenarios[] = {
+    {"ispravan PIN",          sc_correct, "Tocna lozinka!", 0,             1, 1, 0, 0, 0, 0},
+    {"3x pogresan PIN",       sc_lockout, "Zakljucano!",    0,             4, 4, 0, 0, 0, 0},
+    {"promjena lozinke",      sc_change,  "Tocna lozinka!", 0,             3, 3, 0, 0, 0, 0},
+    {"duh + servis. akord",   sc_chord,   "Servis",         "izg:0 duh:1", 1, 0, 0, 0, 0, 0},
+    // Lozinka preživi isključenje; prekinut upis ostavlja staru lozinku.
+    // Operacije flasha: prvi upis (sažimanje u prazan sektor) 1–8, drugi upis 9–14
+    // (zauzmi, 4 riječi, potvrdi); 11 = druga riječ zapisa. Sektor A se obriše dok
+    // brava miruje nakon petog upisa (operacija 35), pa deveti upis sažima u njega
+    // bez brisanja: magic zaglavlja je operacija 61.
+    {"PIN nakon reseta",      sc_change,       "Tocna lozinka!", 0, 1, 1, sc_unlock_5678, 0, 0, 0},
+    {"prekid upisa PIN-a",    sc_change_twice, "Tocna lozinka!", 0, 1, 1, sc_unlock_5678, 11, 0, 0},
+    {"sazimanje 9x",          sc_change_many,  "Tocna lozinka!", 0, 1, 1, sc_unlock_9999, 0, 0, 0},
+    {"prekid sazimanja",      sc_change_many,  "Tocna lozinka!", 0, 1, 1, sc_unlock_8888, 61, 0, 0},
+    // Tablica korisnika se upiše prije paljenja; unosi: jednokratna (točno, pa pogrešno),
+    // opozvana (pogrešno), korisnik, admin, glavna lozinka, zadnji slučajni korisnik
+    {"korisnici (3000)",      sc_setup,        "Tocna lozinka!", 0, 7, 7, sc_users, 0, setup_users, 0},
+    // Watchdog reset nakon otključavanja: LCD ostaje u 4-bitnom načinu i brzo se vraća
+    {"topli reset (IWDG)",    sc_correct,      "Tocna lozinka!", 0, 1, 1, sc_correct, 0, 0, 1},
+};
+
+// Izvedi jedan scenarij (u procesu-djetetu) i ispiši redak tablice
+static int run_scenario(const Scenario *sc) {
+    char line0[41], line1[41];
+
+    sim_reset();
+    uint32_t (*script)(void) = sc->script;
+    if (sc->reboot) {
+        pid_t pid = fork();
+        if (pid == 0) {                    // prvo paljenje (ili do nestanka napajanja)
+            sim_lcd_attach(LCD_ADDR, 16, 2);
+            sim_flash_cut_at(sc->cut_op);
+            sim_run(sc->setup ? sc->setup : firmware_main, sc->script());
+            _exit(0);
+        }
+        waitpid(pid, 0, 0);
+        if (sc->warm) sim_warm_reset();    // i LCD zadržava stanje
+        else sim_power_cycle();            // flash zadržava ono što je upisano
+        script = sc->reboot;
+    }
+    sim_lcd_attach(LCD_ADDR, 16, 2);
+    sim_lcd_watch(LCD_ADDR, 0, PROMPT);
+    uint32_t end_ms = script();
+    sim_run(firmware_main, end_ms);
+
+    const SimBusStats *b = sim_bus_stats();
+    const SimLatency *l = sim_latency();
+    sim_lcd_line(LCD_ADDR, 0, line0);
+    sim_lcd_line(LCD_ADDR, 1, line1);
+
+    // Dnevnik pristupa: 8-bajtni zapisi s rednim brojem bez rupa.
+    // Zapisi profiliranja (AUDIT_EV_PROF) se ne broje nego skupljaju za ispis.
+    uint32_t uart_len;
+    const uint8_t *uart = sim_uart_data(&uart_len);
+    uint32_t records = 0;
+    uint32_t prof_val[PROF_COUNT][4] = {{0}};
+    uint8_t prof_seen[PROF_COUNT] = {0};
+    int audit_ok = (uart_len % 8) == 0;
+    for (uint32_t i = 0; i < uart_len / 8; i++) {
+        const uint8_t *r = uart + i * 8;
+        uint32_t value = r[0] | (r[1] << 8) | (r[2] << 16) | ((uint32_t)r[3] << 24);
+        uint16_t seq = (uint16_t)(r[4] | (r[5] << 8));
+        if (seq != i) audit_ok = 0;
+        if (r[6] == AUDIT_EV_PROF) {
+            uint8_t probe = r[7] >> 5, field = r[7] & 31;
+            if (probe < PROF_COUNT && field < 4) {
+                prof_val[probe][field] = value;
+                prof_seen[probe] = 1;
+            }
+        } else {
+            records++;
+        }
+    }
+    if (records != sc->expect_audit) audit_ok = 0;
+
+    int ok = strncmp(line0, sc->expect0, strlen(sc->expect0)) == 0 && audit_ok;
+    if (sc->expect1) ok = ok && strncmp(line1, sc->expect1, strlen(sc->expect1)) == 0;
+    // Uzorci LED/buzzer: svi odsvirani, a TIM1 nikad ne ostaje upaljen u STOP-u
+    const SimSignalStats *sg = sim_signal_stats();
+    ok = ok && sg->patterns == sc->expect_patterns && sg->stop_running == 0;
+    // Pokretanje: početna poruka se mora pojaviti, a LCD ne smije dobiti naredbu prerano
+    uint64_t prompt_us = sim_lcd_watch_us(LCD_ADDR);
+    ok = ok && prompt_us && sim_lcd_violations(LCD_ADDR) == 0;
+    // Udio vremena u kojem procesor nije spavao (ni Sleep ni STOP)
+    const SimPowerStats *pw = sim_power_stats();
+    uint64_t total_us = (uint64_t)end_ms * 1000;
+    double awake = 100.0 * (double)(total_us - pw->sleep_us - pw->stop_us) / (double)total_us;
+
+    const SimFlashStats *fl = sim_flash_stats();
+    printf("%-18s %7u %8u %10.2f %9.2f %5u %8.2f %8.2f %6u %6u %7.2f %6.1f %6.2f %7.0f %7.0f %4u/%-2u %5u %8.2f  [%s|%s] %s\n",
+           sc->name, b->transfers, b->bytes, b->bus_us / 1000.0, b->cpu_stall_us / 1000.0,
+           l->count, l->count ? (double)l->sum_us / l->count / 1000.0 : 0.0, l->max_us / 1000.0,
+           sim_lcd_violations(LCD_ADDR), records, awake, 100.0 * pw->stop_us / total_us,
+           100.0 * pw->fast_us / total_us, sg->led_us / 1000.0, sg->tone_us / 1000.0,
+           fl->programs, fl->erases, b->cgram_loads, prompt_us / 1000.0, line0, line1, ok ? "OK" : "GRESKA");
+
+    // Statistika profiliranja (samo uz PROF=1 i servisni akord), u virtualnim ciklusima
+    static const char *const prof_names[PROF_COUNT] = PROF_PROBE_NAMES;
+    for (int p = 0; p < PROF_COUNT; p++) {
+        if (!prof_seen[p]) continue;
+        if (p == PROF_SCAN) {              // sonda u SysTick prekidu: simulirani prekid traje 0 µs
+            printf("    prof %-10s n=%-7u (u prekidu; trajanje simulator ne mjeri)\n", prof_names[p], prof_val[p][0]);
+            continue;
+        }
+        printf("    prof %-10s n=%-7u min=%-7u max=%-8u sr=%u\n", prof_names[p],
+               prof_val[p][0], prof_val[p][1], prof_val[p][2], prof_val[p][3]);
+    }
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    int failed = 0;
+
+    printf("%-18s %7s %8s %10s %9s %5s %8s %8s %6s %6s %7s %6s %6s %7s %7s %7s %5s %8s  %s\n",
+           "scenarij", "I2C tr.", "bajtova", "sabir.[ms]", "CPU[ms]", "tipke",
+           "lat.sr.", "lat.max", "kriv.t", "audit", "budno%", "STOP%", "BURST%", "LED[ms]", "ton[ms]",
+           "flash", "CGRAM", "start[ms]", "zaslon na kraju");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            int rc = run_scenario(&scenarios[i]);
+            fflush(stdout);
+            _exit(rc);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+#include "lock_fsm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// --- Replay harness za automat stanja brave ---
+// Kroz LockFsm_Event() pušta milijune slučajnih (ili snimljenih) događaja,
+// mjeri propusnost i nakon svakog koraka provjerava invarijante.
+//
+//   fsm_replay [broj_dogadaja] [seed]     → slučajni niz (zadano 10 000 000, seed 1)
+//   fsm_replay -f datoteka                → snimljeni niz: znakovi tipki, 'R' = tipkalo, 'T' = istek poruke
+//
+// Uz glavnu lozinku pin0 automat ima i dodatnu provjeru koja prihvaća samo pin1
+// (zamjena za tablicu korisnika), pa se unos sam predaje tek na 5 znakova, a
+// kraći unosi s tipkom predaje (KEY_ENTER, kao na tipkovnici 4x4).
+
+#define KEY_ENTER 'D'
+
+static const char *pin0 = "1234";
+static const char *pin1 = "13579";
+
+static uint8_t replay_verify(const char *input, uint8_t len) {
+    return len == strlen(pin1) && memcmp(input, pin1, len) == 0;
+}
+
+static int opened_master;    // zadnje otključavanje je bilo glavnom lozinkom (prati ga check())
+
+static void replay_init(LockFsm *f) {
+    opened_master = 0;
+    LockFsm_Init(f, pin0);
+    LockFsm_SetVerify(f, replay_verify, (uint8_t)strlen(pin1), KEY_ENTER);
+}
+
+// Unos koji bi (prije koraka) uz zadnju tipku bio predan: vraća njegovu duljinu ili -1
+static int submitted(const LockFsm *b, LockEvent ev, char key, char *in) {
+    int n = b->idx;
+    memcpy(in, b->input, (size_t)n);
+    if (ev == LOCK_EV_DIGIT) {
+        if (n + 1 != b->submit_len) return -1;
+        in[n++] = key;
+    } else if (ev != LOCK_EV_ENTER || n < LOCK_PIN_LEN) {
+        return -1;
+    }
+    return n;
+}
+
+// Je li predani unos glavna lozinka
+static int is_master(const LockFsm *b, LockEvent ev, char key) {
+    char in[LOCK_PIN_MAX + 2];
+    int n = submitted(b, ev, key, in);
+    return n == LOCK_PIN_LEN && memcmp(in, b->pin, LOCK_PIN_LEN) == 0;
+}
+
+// Bi li unos (prije koraka) uz zadnju tipku smio otključati
+static int may_open(const LockFsm *b, LockEvent ev, char key) {
+    char in[LOCK_PIN_MAX + 2];
+    int n = submitted(b, ev, key, in);
+    return n >= 0 && (is_master(b, ev, key) || replay_verify(in, (uint8_t)n));
+}
+static unsigned long errors;
+static unsigned long long step_no;
+
+static void fail(const char *what, const LockFsm *before, const LockFsm *after, LockEvent ev, char key) {
+    if (errors++ < 10) {
+        fprintf(stderr, "korak %llu: %s (dogadaj %d '%c', stanje %d → %d, fails %u → %u)\n",
+                step_no, what, (int)ev, key ? key : ' ', (int)before->state, (int)after->state,
+                before->fails, after->fails);
+    }
+}
+
+// Provjera invarijanti nakon jednog koraka
+static void check(const LockFsm *b, const LockFsm *a, LockEvent ev, char key, uint16_t act) {
+    if ((unsigned)a->state >= LOCK_ST_COUNT) fail("nepoznato stanje", b, a, ev, key);
+    if (a->idx > LOCK_PIN_MAX || a->input[a->idx] != '\0') fail("neispravan unos", b, a, ev, key);
+    if (strlen(a->pin) != LOCK_PIN_LEN) fail("neispravna lozinka", b, a, ev, key);
+    if (strchr(a->pin, KEY_ENTER)) fail("lozinka s tipkom predaje", b, a, ev, key);
+    if (a->fails > LOCK_MAX_FAILS) fail("previse gresaka", b, a, ev, key);
+    if (a->state == LOCK_ST_BLOCKED && a->fails < LOCK_MAX_FAILS) fail("blokada bez 3 greske", b, a, ev, key);
+    if ((a->state == LOCK_ST_ENTRY || a->state == LOCK_ST_CHANGE || a->state == LOCK_ST_OPEN) &&
+        a->fails >= LOCK_MAX_FAILS) fail("nije blokirano nakon 3 greske", b, a, ev, key);
+
+    // '*' i tipkalo uvijek vraćaju na početak
+    if (ev == LOCK_EV_STAR || ev == LOCK_EV_RESET) {
+        if (a->state != LOCK_ST_ENTRY || a->fails || a->idx || !(act & LOCK_ACT_OUTPUTS_OFF))
+            fail("reset nije potpun", b, a, ev, key);
+    }
+    // Iz blokade se izlazi samo s '*' ili tipkalom
+    if (b->state == LOCK_ST_BLOCKED && a->state != LOCK_ST_BLOCKED &&
+        ev != LOCK_EV_STAR && ev != LOCK_EV_RESET) fail("izlaz iz blokade", b, a, ev, key);
+    // Otključava se samo kad je predani unos jednak glavnoj lozinci ili ga dodatna provjera prihvati
+    if (a->state == LOCK_ST_OPEN && b->state != LOCK_ST_OPEN && !may_open(b, ev, key))
+        fail("otkljucano bez ispravne lozinke", b, a, ev, key);
+    // Predan ispravan unos uvijek otključa
+    if (b->state == LOCK_ST_ENTRY && a->state != LOCK_ST_OPEN && may_open(b, ev, key))
+        fail("ispravna lozinka nije otkljucala", b, a, ev, key);
+    // Promjena lozinke ('#') samo iz otključanog stanja, i to nakon glavne lozinke:
+    // nova lozinka se trajno sprema, pa je ne smije postaviti netko tko je ne zna
+    if (a->state == LOCK_ST_OPEN && b->state != LOCK_ST_OPEN) opened_master = is_master(b, ev, key);
+    if (a->state == LOCK_ST_CHANGE && b->state != LOCK_ST_CHANGE && !(b->state == LOCK_ST_OPEN && opened_master))
+        fail("promjena lozinke bez glavne lozinke", b, a, ev, key);
+    // Lozinka se mijenja samo na kraju upisa nove lozinke
+    if (strcmp(a->pin, b->pin) != 0 && !(b->state == LOCK_ST_CHANGE && a->state == LOCK_ST_CHANGED))
+        fail("lozinka promijenjena izvan moda promjene", b, a, ev, key);
+    // Lozinka se sprema u flash točno kad je promijenjena
+    if (!(act & LOCK_ACT_PIN_SAVE) != !(b->state == LOCK_ST_CHANGE && a->state == LOCK_ST_CHANGED))
+        fail("spremanje lozinke", b, a, ev, key);
+    // Timer poruke se pokreće samo za poruke koje istječu
+    if ((act & LOCK_ACT_TIMER_START) && a->state != LOCK_ST_WRONG && a->state != LOCK_ST_CHANGED)
+        fail("timer bez poruke", b, a, ev, key);
+    // Uzorak zaključavanja svira samo kod ulaska u blokadu
+    if (!(act & LOCK_ACT_SIGNAL_LOCK) != !(a->state == LOCK_ST_BLOCKED && b->state != LOCK_ST_BLOCKED))
+        fail("uzorak zakljucavanja", b, a, ev, key);
+}
+
+// Jedan korak: primijeni događaj na kopiju i provjeri
+static uint16_t step(LockFsm *f, LockEvent ev, char key, int verify) {
+    LockFsm before;
+    if (verify) before = *f;
+    uint16_t act = LockFsm_Event(f, ev, key);
+    if (verify) check(&before, f, ev, key, act);
+    step_no++;
+    return act;
+}
+
+// xorshift32 – brzi generator slučajnih brojeva
+static uint32_t rng_state = 1;
+static uint32_t rng(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
+
+// Slučajni događaj: uglavnom znamenke (često baš one iz lozinki), ponekad '*', '#', tipkalo,
+// istek i predaja unosa
+static LockEvent random_event(char *key) {
+    static const char digits[] = "0123456789ABCD";   // 'D' kao znamenka: LockFsm_Key() bez tablice
+    uint32_t r = rng() % 100;
+    *key = 0;
+    if (r < 3)  { *key = '*'; return LOCK_EV_STAR; }
+    if (r < 6)  { *key = '#'; return LOCK_EV_HASH; }
+    if (r < 7)  return LOCK_EV_RESET;
+    if (r < 17) return LOCK_EV_TIMEOUT;
+    if (r < 27) { *key = KEY_ENTER; return LOCK_EV_ENTER; }
+    *key = (r < 55) ? "1234"[rng() & 3] : (r < 70) ? "13579"[rng() % 5] : digits[rng() % 14];
+    return LOCK_EV_DIGIT;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int replay_file(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        return 2;
+    }
+    LockFsm f;
+    replay_init(&f);
+    int c;
+    while ((c = fgetc(fp)) != EOF) {
+        if (c == 'R') step(&f, LOCK_EV_RESET, 0, 1);
+        else if (c == 'T') step(&f, LOCK_EV_TIMEOUT, 0, 1);
+        else if (c == '*') step(&f, LOCK_EV_STAR, '*', 1);
+        else if (c == '#') step(&f, LOCK_EV_HASH, '#', 1);
+        else if (c == KEY_ENTER) step(&f, LOCK_EV_ENTER, (char)c, 1);
+        else if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'C')) step(&f, LOCK_EV_DIGIT, (char)c, 1);
+    }
+    fclose(fp);
+    printf("snimljeni niz: %llu dogadaja, konacno stanje %d, gresaka invarijanti: %lu\n",
+           step_no, (int)f.state, errors);
+    return errors ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2 && strcmp(argv[1], "-f") == 0) return replay_file(argv[2]);
+
+    unsigned long long n = (argc > 1) ? strtoull(argv[1], 0, 10) : 10000000ULL;
+    rng_state = (argc > 2) ? (uint32_t)strtoul(argv[2], 0, 10) | 1 : 1;
+
+    // Događaji se generiraju unaprijed da mjerenje propusnosti ne uključuje generator
+    enum { CHUNK = 1 << 16 };
+    static LockEvent evs[CHUNK];
+    static char keys[CHUNK];
+    LockFsm f;
+    replay_init(&f);
+
+    // 1) Provjera invarijanti na cijelom nizu
+    double t0 = seconds();
+    for (unsigned long long done = 0; done < n; done += CHUNK) {
+        for (int i = 0; i < CHUNK; i++) evs[i] = random_event(&keys[i]);
+        for (int i = 0; i < CHUNK && done + i < n; i++) step(&f, evs[i], keys[i], 1);
+    }
+    double t_check = seconds() - t0;
+
+    // 2) Čista propusnost (bez provjera) na istom broju događaja
+    uint32_t sink = 0;
+    unsigned long long states[LOCK_ST_COUNT] = {0};
+    double t_run = 0;
+    replay_init(&f);
+    for (unsigned long long done = 0; done < n; done += CHUNK) {
+        for (int i = 0; i < CHUNK; i++) evs[i] = random_event(&keys[i]);
+        int m = (n - done < CHUNK) ? (int)(n - done) : CHUNK;
+        t0 = seconds();
+        for (int i = 0; i < m; i++) sink += LockFsm_Event(&f, evs[i], keys[i]);
+        t_run += seconds() - t0;
+        states[f.state]++;
+    }
+
+    printf("dogadaja:            %llu\n", n);
+    printf("propusnost:          %.1f M dogadaja/s (%.1f ns/dogadaj)\n", n / t_run / 1e6, t_run * 1e9 / n);
+    printf("s provjerama:        %.1f M dogadaja/s\n", n / t_check / 1e6);
+    printf("gresaka invarijanti: %lu\n", errors);
+    printf("(kontrolni zbroj akcija %u)\n", sink);
+    return errors ? 1 : 0;
+}
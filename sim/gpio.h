@@ -0,0 +1,8 @@
+#ifndef __GPIO_H__   // Zamjena za CubeMX gpio.h u simulatoru
+#define __GPIO_H__
+
+#include "main.h"
+
+void MX_GPIO_Init(void);
+
+#endif // __GPIO_H__
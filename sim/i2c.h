@@ -0,0 +1,10 @@
+#ifndef __I2C_H__   // Zamjena za CubeMX i2c.h u simulatoru
+#define __I2C_H__
+
+#include "main.h"
+
+extern I2C_HandleTypeDef hi2c1;
+
+void MX_I2C1_Init(void);
+
+#endif // __I2C_H__
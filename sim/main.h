@@ -0,0 +1,9 @@
+#ifndef __MAIN_H   // Zamjena za CubeMX main.h u simulatoru
+#define __MAIN_H
+
+#include "stm32f4xx_hal.h"
+
+void Error_Handler(void);
+void SystemClock_Config(void);
+
+#endif // __MAIN_H
@@ -0,0 +1,139 @@
+#ifndef __SIM_H__   // Sučelje simulatora prema benchmark programima
+#define __SIM_H__
+
+#include "stm32f4xx_hal.h"
+
+// --- Virtualni sat ---
+// Vrijeme teče samo kad firmware pozove HAL funkciju (svaki poziv "košta" nekoliko µs),
+// kod HAL_Delay-a, __WFI()-a i blokirajućeg I2C prijenosa. Svaka puna milisekunda poziva
+// HAL_SYSTICK_Callback(), kao pravi SysTick prekid. Simulirani prekidi traju 0 µs
+// (sat se u njima ne pomiče), pa sonde profiliranja unutar prekida mjere samo broj poziva.
+#define SIM_COST_GETTICK_US    1   // cijena jednog HAL_GetTick() poziva
+#define SIM_COST_GPIO_US       1   // cijena jednog HAL_GPIO_ReadPin/WritePin poziva
+#define SIM_COST_I2C_START_US  2   // cijena pokretanja DMA/IT prijenosa
+#define SIM_COST_TIM_READ_US   1   // cijena jednog čitanja TIM5->CNT (READ_REG)
+
+uint64_t sim_now_us(void);
+void sim_advance_us(uint64_t us);
+
+// Pokreće firmware (npr. firmware_main) dok virtualni sat ne dođe do end_ms.
+// Vraća 0 kad je scenarij odrađen do kraja.
+int sim_run(int (*entry)(void), uint32_t end_ms);
+
+// Vraća simulator u početno stanje (sat = 0, prazna skripta, prazni zasloni, obrisan flash).
+void sim_reset(void);
+// Isto, ali flash zadržava sadržaj (isključenje i ponovno paljenje pločice).
+void sim_power_cycle(void);
+// Reset procesora bez nestanka napajanja (watchdog): flash i LCD zadržavaju stanje
+// (LCD ostaje u 4-bitnom načinu s istim sadržajem), a RCC javlja IWDGRST umjesto PORRST.
+void sim_warm_reset(void);
+// Nestanak napajanja: scenarij završava odmah (poziva ga model flasha).
+void sim_power_cut(void);
+
+// --- Skripta ulaza ---
+// Tipka 'key' se pritisne u t_ms i drži hold_ms.
+void sim_script_key(uint32_t t_ms, char key, uint32_t hold_ms);
+// Niz tipki: svaka se drži hold_ms, razmak između početaka pritisaka je gap_ms.
+// Vraća vrijeme (ms) nakon zadnjeg pritiska.
+uint32_t sim_script_keys(uint32_t t_ms, const char *keys, uint32_t hold_ms, uint32_t gap_ms);
+// Tipkalo PC13 se pritisne u t_ms i drži hold_ms.
+void sim_script_reset_button(uint32_t t_ms, uint32_t hold_ms);
+
+// --- I2C sabirnica i LCD ---
+typedef struct {
+    uint32_t transfers;        // broj I2C prijenosa (adresnih faza)
+    uint32_t bytes;            // broj podatkovnih bajtova (bez adrese)
+    uint64_t bus_us;           // ukupno vrijeme zauzeća sabirnice
+    uint64_t cpu_stall_us;     // vrijeme koje je CPU čekao na sabirnicu
+    uint32_t cgram_loads;      // naredbe "set CGRAM address" (učitavanje ikone u LCD)
+} SimBusStats;
+
+const SimBusStats *sim_bus_stats(void);
+
+// Priključuje virtualni PCF8574 + HD44780 LCD na 7-bitnu adresu addr.
+void sim_lcd_attach(uint8_t addr, uint8_t cols, uint8_t rows);
+// Kopira vidljivi sadržaj reda 'row' u out (cols znakova + '\0'). CGRAM znakovi se ispisuju kao '~'.
+void sim_lcd_line(uint8_t addr, uint8_t row, char *out);
+// Broj prekršaja vremena (naredba poslana dok je HD44780 još bio zauzet).
+uint32_t sim_lcd_violations(uint8_t addr);
+// Vrijeme (µs) kad je na zaslonu prvi put promijenjena neka vidljiva ćelija.
+uint64_t sim_lcd_first_pixel_us(uint8_t addr);
+// Prati red 'row': sim_lcd_watch_us() vraća vrijeme (µs) kad red prvi put počinje
+// tekstom 'text' (0 = još nije). Tekst mora postojati do kraja scenarija.
+void sim_lcd_watch(uint8_t addr, uint8_t row, const char *text);
+uint64_t sim_lcd_watch_us(uint8_t addr);
+
+// --- UART (USART2) ---
+// Prijenos traje 10 bitova po bajtu na Init.BaudRate, a HAL_UART_TxCpltCallback()
+// se poziva kao prekid kad virtualni sat dođe do kraja prijenosa.
+// Vraća sve bajtove poslane od sim_reset() i njihov broj u *len.
+const uint8_t *sim_uart_data(uint32_t *len);
+
+// --- Potrošnja: vrijeme u Sleep i STOP modu i na brzom taktu ---
+typedef struct {
+    uint64_t sleep_us;         // ukupno vrijeme u Sleep modu (WFI)
+    uint64_t stop_us;          // ukupno vrijeme u STOP modu
+    uint32_t sleep_count;      // broj ulazaka u Sleep
+    uint32_t stop_count;       // broj ulazaka u STOP
+    uint64_t fast_us;          // ukupno vrijeme sa SystemCoreClock iznad 16 MHz (PLL)
+} SimPowerStats;
+
+const SimPowerStats *sim_power_stats(void);
+
+// --- LED i buzzer (TIM1 uzorci, vidi pattern.h) ---
+typedef struct {
+    uint64_t led_us;           // vrijeme upaljenog LED-a (PWM se množi sa svjetlinom)
+    uint64_t tone_us;          // vrijeme u kojem buzzer svira ton
+    uint32_t patterns;         // uzorci čiju je tablicu DMA prenio do kraja
+    uint32_t stop_running;     // ulasci u STOP dok TIM1 još broji (greška)
+} SimSignalStats;
+
+const SimSignalStats *sim_signal_stats(void);
+
+// --- Flash (vidi sim_flash.c) ---
+typedef struct {
+    uint32_t ops;              // sve operacije (upisi i brisanja), redom kako ih broji sim_flash_cut_at
+    uint32_t programs;         // upisi (bajt, polovica riječi ili riječ)
+    uint32_t erases;           // brisanja sektora
+    uint64_t busy_us;          // vrijeme u kojem je CPU čekao flash
+} SimFlashStats;
+
+const SimFlashStats *sim_flash_stats(void);
+// Napajanje nestaje na operaciji broj 'op' (od sim_reset(), počevši od 1), prije nego
+// se išta upiše ili obriše. 0 = nikad.
+void sim_flash_cut_at(uint32_t op);
+
+// --- Kašnjenje od pritiska tipke do promjene na zaslonu ---
+typedef struct {
+    uint32_t count;            // broj izmjerenih pritisaka
+    uint32_t missed;           // pritisci nakon kojih se zaslon nije promijenio
+    uint64_t sum_us;           // zbroj kašnjenja
+    uint64_t max_us;           // najveće kašnjenje
+} SimLatency;
+
+const SimLatency *sim_latency(void);
+
+// --- Interno: veza između sim_hal.c, sim_lcd.c, sim_uart.c i sim_tim.c ---
+void sim_latency_press(uint64_t t_us);
+void sim_latency_pixel(uint64_t t_us);
+void sim_lcd_reset(void);
+void sim_lcd_warm_reset(void);    // LCD ostaje napajan: sadržaj i način rada se zadržavaju
+void sim_uart_reset(void);
+uint64_t sim_uart_irq_at(void);   // kada stiže sljedeći UART prekid (0 = nijedan)
+void sim_uart_irq(void);          // obradi UART prekid (poziva se iz sim_advance_us)
+uint64_t sim_i2c_irq_at(void);    // kada završava I2C prijenos u tijeku (0 = sabirnica slobodna)
+void sim_i2c_irq(void);           // obradi I2C prekid završetka (poziva se iz sim_advance_us)
+void sim_i2c_stall(uint64_t us);  // CPU je spavao (WFI) dok je I2C prijenos bio u tijeku
+void sim_tim_reset(void);
+void sim_flash_reset(void);
+void sim_tim_sync(uint64_t now);  // firmware je možda pokrenuo/zaustavio TIM1
+uint64_t sim_tim_event_at(void);  // kraj sljedeće periode TIM1 (0 = brojilo stoji)
+void sim_tim_advance(uint64_t now);
+int sim_tim_irq_pending(void);    // DMA burst je gotov, čeka prekid
+void sim_tim_irq(void);
+void sim_tim_stop_mode(void);     // ulazak u STOP
+uint32_t sim_apb1_timer_hz(void); // takt timera na APB1 (TIM5)
+uint32_t sim_apb2_timer_hz(void); // takt timera na APB2
+uint32_t sim_tim5_count(void);    // vrijednost brojila TIM5 (čitanje CNT-a)
+
+#endif // __SIM_H__
@@ -0,0 +1,107 @@
+#include "sim.h"
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+// --- Model flasha (sektori 0–3 po 16 KB, sektor 4 od 64 KB, sektori 5–7 po 128 KB) ---
+// Upis samo briše bitove (1 → 0), kao na pločici; brisanje sektora vraća 0xFF.
+// Upis i brisanje zaustavljaju CPU (vrijeme iz datasheeta STM32F401, x32).
+// Flash je u dijeljenoj memoriji (mmap), pa ga proces nastao s fork() nakon
+// sim_reset() vidi i mijenja: benchmark tako simulira isključenje i ponovno paljenje.
+
+#define SIM_FLASH_SECTOR     0x4000U   // sektori 0–3
+#define SIM_FLASH_SECTORS    FLASH_SECTOR_TOTAL
+#define SIM_FLASH_PROG_US    16        // upis riječi (tipično)
+#define SIM_FLASH_ERASE_US   250000    // brisanje sektora od 16 KB (tipično)
+#define SIM_FLASH_ERASE64_US 550000    // brisanje sektora od 64 KB (tipično)
+#define SIM_FLASH_ERASE128_US 1000000  // brisanje sektora od 128 KB (tipično)
+
+uint8_t *sim_flash;
+uint16_t sim_flash_size_kb = SIM_FLASH_SIZE / 1024U;   // kao F401xE (512 KB)
+
+typedef struct {
+    uint8_t mem[SIM_FLASH_SIZE];
+    SimFlashStats stats;
+} SimFlashShared;
+
+static SimFlashShared *shared;
+static int locked = 1;
+static uint32_t cut_op;              // redni broj operacije na kojoj nestaje napajanja (0 = nikad)
+
+void sim_flash_reset(void) {
+    if (!shared) {
+        shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shared == MAP_FAILED) abort();
+        sim_flash = shared->mem;
+    }
+    memset(shared->mem, 0xFF, sizeof(shared->mem));
+    memset(&shared->stats, 0, sizeof(shared->stats));
+    locked = 1;
+    cut_op = 0;
+}
+
+void sim_flash_cut_at(uint32_t op) {
+    cut_op = op;
+}
+
+const SimFlashStats *sim_flash_stats(void) {
+    return &shared->stats;
+}
+
+// Početak i veličina sektora (sektor 4 počinje iza četiri sektora od 16 KB, sektor 5 na 128 KB)
+static uint32_t sim_flash_sector_ofs(uint32_t s) {
+    return (s < 4) ? s * SIM_FLASH_SECTOR : (s == 4) ? 4 * SIM_FLASH_SECTOR : (s - 4) * 0x20000U;
+}
+
+static uint32_t sim_flash_sector_size(uint32_t s) {
+    return (s < 4) ? SIM_FLASH_SECTOR : (s == 4) ? 0x10000U : 0x20000U;
+}
+
+// Svaka operacija se broji; na odabranoj nestaje napajanja (prije nego se išta upiše)
+static void sim_flash_op(void) {
+    shared->stats.ops++;
+    if (cut_op && shared->stats.ops == cut_op) sim_power_cut();
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+    locked = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+    locked = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data) {
+    uint32_t size = (TypeProgram == FLASH_TYPEPROGRAM_WORD) ? 4 :
+                    (TypeProgram == FLASH_TYPEPROGRAM_HALFWORD) ? 2 : 1;
+    if (locked || Address < FLASH_BASE || Address + size > FLASH_BASE + SIM_FLASH_SIZE ||
+        (Address & (size - 1))) return HAL_ERROR;
+
+    sim_flash_op();
+    uint8_t *p = sim_flash + (Address - FLASH_BASE);
+    for (uint32_t i = 0; i < size; i++) {
+        p[i] &= (uint8_t)(Data >> (8 * i));   // samo 1 → 0
+    }
+    shared->stats.programs++;
+    shared->stats.busy_us += SIM_FLASH_PROG_US;
+    sim_advance_us(SIM_FLASH_PROG_US);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError) {
+    *SectorError = 0xFFFFFFFFU;
+    if (locked || pEraseInit->TypeErase != FLASH_TYPEERASE_SECTORS ||
+        pEraseInit->Sector + pEraseInit->NbSectors > SIM_FLASH_SECTORS) return HAL_ERROR;
+
+    for (uint32_t s = pEraseInit->Sector; s < pEraseInit->Sector + pEraseInit->NbSectors; s++) {
+        uint32_t us = (s < 4) ? SIM_FLASH_ERASE_US : (s == 4) ? SIM_FLASH_ERASE64_US : SIM_FLASH_ERASE128_US;
+        sim_flash_op();
+        memset(sim_flash + sim_flash_sector_ofs(s), 0xFF, sim_flash_sector_size(s));
+        shared->stats.erases++;
+        shared->stats.busy_us += us;
+        sim_advance_us(us);
+    }
+    return HAL_OK;
+}
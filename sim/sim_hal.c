@@ -0,0 +1,513 @@
+#include "sim.h"
+#include "main.h"
+#include "i2c.h"
+#include "gpio.h"
+#include "keypad_layout.h"
+#include <setjmp.h>
+#include <string.h>
+#include <stdlib.h>
+
+// --- Periferija koju firmware vidi preko makroa GPIOA, GPIOC, I2C1 ---
+GPIO_TypeDef sim_gpioa;
+GPIO_TypeDef sim_gpiob;
+GPIO_TypeDef sim_gpioc;
+DWT_Type sim_dwt;
+IWDG_TypeDef sim_iwdg;
+EXTI_TypeDef sim_exti;
+SYSCFG_TypeDef sim_syscfg;
+CoreDebug_Type sim_coredebug;
+I2C_TypeDef sim_i2c1;
+I2C_HandleTypeDef hi2c1;
+uint32_t SystemCoreClock = 16000000U;
+
+// --- Virtualni sat ---
+static uint64_t now_us;          // trenutno virtualno vrijeme
+static uint64_t end_us;          // kraj scenarija
+static jmp_buf end_jmp;          // povratak iz firmware-a na kraju scenarija
+static int in_isr;               // 1 dok se izvršava simulirani SysTick prekid
+static int irq_disabled;         // __disable_irq()
+static uint32_t uw_tick;         // HAL tick, raste u SysTicku kao uwTick u HAL-u
+static int tick_suspended;       // HAL_SuspendTick()
+static SimPowerStats power;      // vrijeme u Sleep/STOP modu i na brzom taktu
+static uint64_t fast_since;      // od kada je SystemCoreClock iznad 16 MHz
+static uint64_t cyc_base;        // ciklusi odbrojani do zadnje promjene takta jezgre
+static uint64_t cyc_since;       // od kada vrijedi trenutni SystemCoreClock
+
+// --- Stanje RCC-a ---
+#define SIM_PLL_LOCK_US   100    // vrijeme zaključavanja PLL-a
+static int pll_on;               // PLL je upaljen
+static int sysclk_pll;           // SYSCLK dolazi iz PLL-a
+static uint32_t pll_hz;          // izlaz PLL-a (P)
+static uint32_t pclk1_hz = 16000000U;
+static uint32_t pclk2_hz = 16000000U;
+static uint32_t apb1_div = 1;
+static uint32_t apb2_div = 1;
+static uint32_t rcc_csr;         // zastavice uzroka reseta (bitovi 25–31 kao u RCC_CSR)
+
+// --- Promjena takta jezgre (pamti vrijeme provedeno iznad 16 MHz) ---
+// Ciklusi odbrojani starim taktom se pribroje bazi, pa CYCCNT i preko promjene
+// profila samo raste, kao na pločici.
+static void sim_set_core_clock(uint32_t hz) {
+    if (SystemCoreClock > 16000000U) power.fast_us += now_us - fast_since;
+    cyc_base += (now_us - cyc_since) * (SystemCoreClock / 1000000U);
+    cyc_since = now_us;
+    SystemCoreClock = hz;
+    fast_since = now_us;
+}
+
+// --- Skripta ulaza ---
+#define SIM_EV_KEY_DOWN   0
+#define SIM_EV_KEY_UP     1
+#define SIM_EV_RST_DOWN   2
+#define SIM_EV_RST_UP     3
+#define SIM_MAX_EVENTS    512
+
+typedef struct {
+    uint64_t t_us;
+    uint8_t type;
+    char key;
+} SimEvent;
+
+static SimEvent script[SIM_MAX_EVENTS];
+static int script_len;
+static int script_pos;
+
+// --- Tipkovnica kako je spojena na pločici ---
+// Ožičenje se uzima iz keypad_layout.h pa simulator prati odabrani KEYPAD_LAYOUT:
+// redovi su izlazi, kolone ulazi (HIGH = pritisnuto u aktivnom redu)
+#define SIM_ROW_PIN(pin) (pin),
+static const uint16_t sim_row_pins[KEYPAD_ROWS] = { KEYPAD_ROW_LIST(SIM_ROW_PIN) };
+static const char sim_keymap[KEYPAD_KEYS + 1] = KEYPAD_KEYMAP;
+static uint32_t keys_down;       // bit (red * KEYPAD_COLS + kolona) = tipka je pritisnuta
+static int reset_down;           // tipkalo PC13 je pritisnuto
+
+// --- Izračun ulaznih pinova iz izlaza i stanja tipki ---
+static void sim_gpio_update(void) {
+    uint32_t idr = 0;
+    for (int r = 0; r < KEYPAD_ROWS; r++) {
+        if (!(KEYPAD_PORT->ODR & sim_row_pins[r])) continue;  // red nije aktivan
+        for (int c = 0; c < KEYPAD_COLS; c++) {
+            if (keys_down & (1u << (r * KEYPAD_COLS + c))) idr |= 1u << (KEYPAD_COL_SHIFT + c);
+        }
+    }
+    KEYPAD_PORT->IDR = (KEYPAD_PORT->ODR & ~KEYPAD_COL_PINS) | idr; // izlazni pinovi čitaju svoje stanje
+    sim_gpioc.IDR = reset_down ? 0 : GPIO_PIN_13;          // PC13: pull-up, pritisak = LOW
+}
+
+static void sim_apply_event(const SimEvent *ev) {
+    int bit = -1;
+    for (int i = 0; i < KEYPAD_KEYS; i++) {
+        if (sim_keymap[i] == ev->key) bit = i;
+    }
+    switch (ev->type) {
+    case SIM_EV_KEY_DOWN:
+        if (bit >= 0) keys_down |= 1u << bit;
+        sim_latency_press(ev->t_us);
+        break;
+    case SIM_EV_KEY_UP:
+        if (bit >= 0) keys_down &= ~(1u << bit);
+        break;
+    case SIM_EV_RST_DOWN:
+        reset_down = 1;
+        sim_latency_press(ev->t_us);
+        break;
+    case SIM_EV_RST_UP:
+        reset_down = 0;
+        break;
+    }
+    sim_gpio_update();
+}
+
+uint64_t sim_now_us(void) {
+    return now_us;
+}
+
+// --- Pomak virtualnog sata: obradi skriptu, SysTick i kraj scenarija ---
+void sim_advance_us(uint64_t us) {
+    if (in_isr) return;                      // vrijeme u prekidu ne mjerimo
+    uint64_t target = now_us + us;
+    for (;;) {
+        sim_tim_sync(now_us);
+        uint64_t next_tick = (now_us / 1000 + 1) * 1000;
+        uint64_t step = target;
+        if (next_tick < step) step = next_tick;
+        if (script_pos < script_len && script[script_pos].t_us < step && script[script_pos].t_us > now_us) {
+            step = script[script_pos].t_us;
+        }
+        uint64_t uart_at = sim_uart_irq_at();
+        if (uart_at && uart_at < step && uart_at > now_us) step = uart_at;
+        uint64_t i2c_at = sim_i2c_irq_at();
+        if (i2c_at && i2c_at < step && i2c_at > now_us) step = i2c_at;
+        uint64_t tim_at = sim_tim_event_at();
+        if (tim_at && tim_at < step && tim_at > now_us) step = tim_at;
+        now_us = step;
+        sim_tim_advance(now_us);
+
+        while (script_pos < script_len && script[script_pos].t_us <= now_us) {
+            sim_apply_event(&script[script_pos++]);
+        }
+        if (now_us == next_tick && !tick_suspended) {
+            uw_tick++;
+            if (!irq_disabled) {
+                in_isr = 1;
+                HAL_SYSTICK_Callback();      // simulirani SysTick prekid
+                in_isr = 0;
+            }
+        }
+        uart_at = sim_uart_irq_at();
+        if (uart_at && uart_at <= now_us && !irq_disabled) {
+            in_isr = 1;
+            sim_uart_irq();                  // DMA/UART prijenos je gotov
+            in_isr = 0;
+        }
+        i2c_at = sim_i2c_irq_at();
+        if (i2c_at && i2c_at <= now_us && !irq_disabled) {
+            in_isr = 1;
+            sim_i2c_irq();                   // DMA/I2C prijenos je gotov (sljedeći iz reda kreće odmah)
+            in_isr = 0;
+        }
+        if (sim_tim_irq_pending() && !irq_disabled) {
+            in_isr = 1;
+            sim_tim_irq();                   // DMA burst TIM1 je prenio cijelu tablicu
+            in_isr = 0;
+        }
+        if (now_us >= end_us) longjmp(end_jmp, 1);
+        if (now_us >= target) break;
+    }
+}
+
+int sim_run(int (*entry)(void), uint32_t end_ms) {
+    end_us = (uint64_t)end_ms * 1000;
+    if (setjmp(end_jmp)) return 0;           // scenarij je gotov
+    entry();
+    return 1;                                // firmware se vratio iz main() (ne bi smio)
+}
+
+// Zajednički dio svakog reseta procesora: sat, RCC, skripta i periferija
+static void sim_mcu_reset(void) {
+    now_us = 0;
+    in_isr = 0;
+    irq_disabled = 0;
+    uw_tick = 0;
+    tick_suspended = 0;
+    memset(&power, 0, sizeof(power));
+    memset(&sim_exti, 0, sizeof(sim_exti));
+    memset(&sim_syscfg, 0, sizeof(sim_syscfg));
+    SystemCoreClock = 16000000U;
+    pll_on = 0;
+    sysclk_pll = 0;
+    pll_hz = 0;
+    pclk1_hz = 16000000U;
+    pclk2_hz = 16000000U;
+    apb1_div = 1;
+    apb2_div = 1;
+    fast_since = 0;
+    cyc_base = 0;
+    cyc_since = 0;
+    script_len = 0;
+    script_pos = 0;
+    keys_down = 0;
+    reset_down = 0;
+    memset(&sim_gpioa, 0, sizeof(sim_gpioa));
+    memset(&sim_gpioc, 0, sizeof(sim_gpioc));
+    sim_uart_reset();
+    sim_tim_reset();
+    sim_gpio_update();
+}
+
+void sim_power_cycle(void) {
+    sim_mcu_reset();
+    sim_lcd_reset();
+    rcc_csr = (1u << (RCC_FLAG_BORRST & 0x1F)) | (1u << (RCC_FLAG_PORRST & 0x1F)) |
+              (1u << (RCC_FLAG_PINRST & 0x1F));
+}
+
+// Watchdog povlači i NRST pin, pa je uz IWDGRST postavljen i PINRST
+void sim_warm_reset(void) {
+    sim_mcu_reset();
+    sim_lcd_warm_reset();
+    rcc_csr = (1u << (RCC_FLAG_IWDGRST & 0x1F)) | (1u << (RCC_FLAG_PINRST & 0x1F));
+}
+
+void sim_reset(void) {
+    sim_power_cycle();
+    sim_flash_reset();
+}
+
+void sim_power_cut(void) {
+    longjmp(end_jmp, 1);
+}
+
+// --- Skripta: umetni događaj tako da polje ostane sortirano po vremenu ---
+static void sim_script_add(uint64_t t_us, uint8_t type, char key) {
+    if (script_len >= SIM_MAX_EVENTS) abort();
+    int i = script_len++;
+    while (i > 0 && script[i - 1].t_us > t_us) {
+        script[i] = script[i - 1];
+        i--;
+    }
+    script[i].t_us = t_us;
+    script[i].type = type;
+    script[i].key = key;
+}
+
+void sim_script_key(uint32_t t_ms, char key, uint32_t hold_ms) {
+    sim_script_add((uint64_t)t_ms * 1000, SIM_EV_KEY_DOWN, key);
+    sim_script_add((uint64_t)(t_ms + hold_ms) * 1000, SIM_EV_KEY_UP, key);
+}
+
+uint32_t sim_script_keys(uint32_t t_ms, const char *keys, uint32_t hold_ms, uint32_t gap_ms) {
+    while (*keys) {
+        sim_script_key(t_ms, *keys++, hold_ms);
+        t_ms += gap_ms;
+    }
+    return t_ms;
+}
+
+void sim_script_reset_button(uint32_t t_ms, uint32_t hold_ms) {
+    sim_script_add((uint64_t)t_ms * 1000, SIM_EV_RST_DOWN, 0);
+    sim_script_add((uint64_t)(t_ms + hold_ms) * 1000, SIM_EV_RST_UP, 0);
+}
+
+// --- Jezgra HAL-a ---
+void sim_disable_irq(void) { irq_disabled = 1; }
+void sim_enable_irq(void)  { irq_disabled = 0; }
+
+HAL_StatusTypeDef HAL_Init(void) {
+    return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void) {
+    sim_advance_us(SIM_COST_GETTICK_US);
+    return uw_tick;
+}
+
+// Kao pravi HAL_Delay: čeka najmanje Delay + 1 tick
+void HAL_Delay(uint32_t Delay) {
+    uint32_t start = uw_tick;
+    uint32_t wait = (Delay < HAL_MAX_DELAY) ? Delay + 1 : Delay;
+    while (uw_tick - start < wait) {
+        sim_advance_us(1000 - now_us % 1000);   // do sljedećeg SysTicka
+    }
+}
+
+void HAL_SuspendTick(void) { tick_suspended = 1; }
+void HAL_ResumeTick(void)  { tick_suspended = 0; }
+
+// --- Sleep: spavaj do sljedećeg prekida (SysTick, kraj UART ili I2C prijenosa) ---
+// Vraća koliko je spavanje trajalo.
+static uint64_t sim_sleep(void) {
+    uint64_t t0 = now_us;
+    uint64_t wake = (now_us / 1000 + 1) * 1000;
+    uint64_t uart_at = sim_uart_irq_at();
+    if (uart_at && uart_at > now_us && uart_at < wake) wake = uart_at;
+    uint64_t i2c_at = sim_i2c_irq_at();
+    if (i2c_at && i2c_at > now_us && i2c_at < wake) wake = i2c_at;
+    power.sleep_count++;
+    power.sleep_us += wake - t0;             // prije skoka: kraj scenarija može prekinuti spavanje
+    sim_advance_us(wake - now_us);
+    return wake - t0;
+}
+
+void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry) {
+    (void)Regulator;
+    (void)SLEEPEntry;
+    sim_sleep();
+}
+
+// __WFI() izravno iz drivera: čekanje na kraj prijenosa, pa se broji i kao čekanje sabirnice
+void sim_wfi(void) {
+    int i2c_busy = sim_i2c_irq_at() != 0;
+    uint64_t us = sim_sleep();
+    if (i2c_busy) sim_i2c_stall(us);
+}
+
+// --- Razina EXTI linije s porta odabranog u SYSCFG_EXTICR ---
+static uint32_t sim_exti_levels(uint32_t lines) {
+    GPIO_TypeDef *ports[] = {&sim_gpioa, &sim_gpiob, &sim_gpioc};
+    uint32_t levels = 0;
+    sim_gpio_update();
+    for (uint32_t line = 0; line < 16; line++) {
+        if (!(lines & (1u << line))) continue;
+        uint32_t port = (sim_syscfg.EXTICR[line >> 2] >> ((line & 3u) * 4u)) & 0xFu;
+        if (port < 3 && (ports[port]->IDR & (1u << line))) levels |= 1u << line;
+    }
+    return levels;
+}
+
+// --- STOP: bez SysTicka, sat skače od događaja do događaja iz skripte do EXTI brida ---
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry) {
+    (void)Regulator;
+    (void)STOPEntry;
+    uint32_t lines = (sim_exti.EMR | sim_exti.IMR) & 0xFFFFu;
+    uint32_t last = sim_exti_levels(lines);
+    uint64_t t0 = now_us;
+    power.stop_count++;
+    sim_tim_stop_mode();
+    sim_set_core_clock(SystemCoreClock);     // zaključi cikluse prije STOP-a
+
+    for (;;) {
+        if (script_pos >= script_len || script[script_pos].t_us >= end_us) {
+            power.stop_us += end_us - t0;    // ništa više ne budi → spava do kraja scenarija
+            now_us = end_us;
+            longjmp(end_jmp, 1);
+        }
+        if (script[script_pos].t_us > now_us) now_us = script[script_pos].t_us;
+        while (script_pos < script_len && script[script_pos].t_us <= now_us) {
+            sim_apply_event(&script[script_pos++]);
+        }
+        uint32_t levels = sim_exti_levels(lines);
+        uint32_t edges = ((~last & levels) & sim_exti.RTSR) | ((last & ~levels) & sim_exti.FTSR);
+        last = levels;
+        if (edges & lines) break;
+    }
+
+    power.stop_us += now_us - t0;
+    cyc_since = now_us;                      // u STOP-u jezgra nema takta, CYCCNT stoji
+    pll_on = 0;                              // nakon STOP-a sistemski takt je HSI, PLL je ugašen
+    sysclk_pll = 0;
+    sim_set_core_clock(16000000U);
+    pclk1_hz = 16000000U;
+    pclk2_hz = 16000000U;
+    apb1_div = 1;
+    apb2_div = 1;
+}
+
+const SimPowerStats *sim_power_stats(void) {
+    if (SystemCoreClock > 16000000U) {       // zaključi interval koji još traje
+        power.fast_us += now_us - fast_since;
+        fast_since = now_us;
+    }
+    return &power;
+}
+
+__attribute__((weak)) void HAL_SYSTICK_Callback(void) {
+}
+
+// --- GPIO ---
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (PinState == GPIO_PIN_SET) GPIOx->ODR |= GPIO_Pin;
+    else GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    sim_gpio_update();
+    sim_advance_us(SIM_COST_GPIO_US);
+}
+
+// BSRR: donjih 16 bitova postavlja, gornjih 16 briše pinove (postavljanje ima prednost)
+void sim_write_reg(volatile uint32_t *reg, uint32_t val) {
+    GPIO_TypeDef *ports[] = {&sim_gpioa, &sim_gpiob, &sim_gpioc};
+    for (int i = 0; i < 3; i++) {
+        if (reg == &ports[i]->BSRR) {
+            ports[i]->ODR = (ports[i]->ODR & ~(val >> 16)) | (val & 0xFFFFu);
+            sim_gpio_update();
+            return;
+        }
+    }
+    *reg = val;
+}
+
+uint32_t sim_read_reg(volatile uint32_t *reg) {
+    if (reg == &sim_dwt.CYCCNT) {            // virtualni brojač ciklusa
+        return (uint32_t)(cyc_base + (now_us - cyc_since) * (SystemCoreClock / 1000000U));
+    }
+    if (reg == &sim_tim5.CNT) return sim_tim5_count();   // brojilo TIM5 iz virtualnog sata
+    sim_gpio_update();
+    return *reg;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    sim_gpio_update();
+    GPIO_PinState st = (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+    sim_advance_us(SIM_COST_GPIO_US);
+    return st;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    GPIOx->ODR ^= GPIO_Pin;
+    sim_gpio_update();
+    sim_advance_us(SIM_COST_GPIO_US);
+}
+
+// --- RCC (takt se pamti; o njemu ovise CYCCNT, PCLK1 i provjera I2C inicijalizacije) ---
+// PLL se pali/gasi u OscConfig, a SYSCLK, HCLK i PCLK1 se računaju u ClockConfig.
+// Kao na pločici: PLL koji je izvor SYSCLK-a ne smije se ugasiti, a PLL kao izvor
+// se ne može odabrati dok nije upaljen.
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct) {
+    const RCC_PLLInitTypeDef *pll = &RCC_OscInitStruct->PLL;
+    if (pll->PLLState == RCC_PLL_OFF) {
+        if (sysclk_pll) return HAL_ERROR;
+        pll_on = 0;
+    } else if (pll->PLLState == RCC_PLL_ON) {
+        if (sysclk_pll || pll->PLLM == 0 || pll->PLLP == 0) return HAL_ERROR;
+        pll_hz = 16000000U / pll->PLLM * pll->PLLN / pll->PLLP;
+        pll_on = 1;
+        sim_advance_us(SIM_PLL_LOCK_US);     // čekanje da PLL uhvati frekvenciju
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency) {
+    (void)FLatency;
+    uint32_t sysclk;
+    if (RCC_ClkInitStruct->SYSCLKSource == RCC_SYSCLKSOURCE_PLLCLK) {
+        if (!pll_on) return HAL_ERROR;
+        sysclk = pll_hz;
+        sysclk_pll = 1;
+    } else {
+        sysclk = 16000000U;
+        sysclk_pll = 0;
+    }
+    sim_set_core_clock(sysclk / RCC_ClkInitStruct->AHBCLKDivider);
+    pclk1_hz = SystemCoreClock / RCC_ClkInitStruct->APB1CLKDivider;
+    pclk2_hz = SystemCoreClock / RCC_ClkInitStruct->APB2CLKDivider;
+    apb1_div = RCC_ClkInitStruct->APB1CLKDivider;
+    apb2_div = RCC_ClkInitStruct->APB2CLKDivider;
+    return HAL_OK;                           // SysTick se ponovno podesi (HAL_InitTick), tick ne skače
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void) {
+    return SystemCoreClock;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return pclk1_hz;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+    return pclk2_hz;
+}
+
+// Kao na pločici: uz APB djelitelj veći od 1 timeri dobivaju dvostruki PCLK
+uint32_t sim_apb1_timer_hz(void) {
+    return apb1_div > 1 ? pclk1_hz * 2 : pclk1_hz;
+}
+
+uint32_t sim_apb2_timer_hz(void) {
+    return apb2_div > 1 ? pclk2_hz * 2 : pclk2_hz;
+}
+
+// --- Uzrok reseta ---
+int sim_rcc_flag(uint8_t flag) {
+    return (rcc_csr >> (flag & 0x1F)) & 1u;
+}
+
+void sim_rcc_clear_reset_flags(void) {
+    rcc_csr = 0;
+}
+
+// --- Zamjena za CubeMX gpio.c / i2c.c ---
+void MX_GPIO_Init(void) {
+    sim_gpio_update();
+}
+
+void MX_I2C1_Init(void) {
+    hi2c1.Instance = I2C1;
+    hi2c1.Init.ClockSpeed = 100000;
+    hi2c1.Init.DutyCycle = I2C_DUTYCYCLE_2;
+    hi2c1.Init.OwnAddress1 = 0;
+    hi2c1.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+    hi2c1.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+    hi2c1.Init.OwnAddress2 = 0;
+    hi2c1.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+    hi2c1.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+    HAL_I2C_Init(&hi2c1);
+}
@@ -0,0 +1,363 @@
+#include "sim.h"
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+// --- Virtualni PCF8574 + HD44780 ---
+// PCF8574 bitovi: P0 = RS, P1 = RW, P2 = E, P3 = pozadinsko svjetlo, P4–P7 = D4–D7.
+// HD44780 preuzima nibble na silaznom bridu E. Dok je u 8-bitnom načinu (nakon
+// uključenja), svaki nibble je cijela naredba (D0–D3 su spojeni na 0).
+// Zasloni su u dijeljenoj memoriji (mmap, kao flash), pa reset procesora bez nestanka
+// napajanja u benchmarku zatekne LCD onakvim kakvim ga je ostavio prethodni proces.
+
+#define SIM_MAX_LCDS        4
+#define SIM_LCD_POWER_US    40000   // nakon uključenja LCD treba > 40 ms (datasheet, 2.7 V)
+#define SIM_LCD_EXEC_US     37      // tipično trajanje naredbe
+#define SIM_LCD_DATA_US     41      // upis znaka (37 + 4 µs)
+#define SIM_LCD_CLEAR_US    1520    // clear / return home
+#define SIM_LCD_INIT1_US    4100    // nakon prvog 0x30 u 8-bitnom načinu
+#define SIM_LCD_INIT2_US    100     // nakon drugog 0x30
+
+typedef struct {
+    uint8_t used;
+    uint8_t addr;                   // 7-bitna I2C adresa
+    uint8_t cols, rows;             // geometrija zaslona
+    uint8_t prev;                   // zadnji bajt upisan u PCF8574
+    uint8_t mode4;                  // 1 = 4-bitni način
+    uint8_t have_hi;                // 1 = primljen gornji nibble, čeka se donji
+    uint8_t hi;                     // gornji nibble (s RS bitom)
+    uint8_t init_stage;             // broj 0x30 naredbi primljenih u 8-bitnom načinu
+    uint8_t ddram[128];
+    uint8_t cgram[64];
+    uint8_t ac;                     // brojač adrese
+    uint8_t ac_cgram;               // 1 = AC pokazuje u CGRAM
+    uint8_t display_on;
+    uint64_t busy_until;            // do kada HD44780 izvršava zadnju naredbu
+    uint32_t violations;            // naredbe poslane dok je HD44780 bio zauzet
+    uint64_t first_pixel;           // prva promjena vidljive ćelije (0 = još nije bilo)
+    uint64_t ready_at;              // od kada LCD smije primati naredbe (kraj uključenja)
+    const char *watch;              // praćeni tekst (sim_lcd_watch) ili 0
+    uint8_t watch_row;
+    uint64_t watch_at;              // kada se tekst prvi put pojavio (0 = još nije)
+} SimLcd;
+
+static SimLcd *lcds;                // SIM_MAX_LCDS zaslona u dijeljenoj memoriji
+static SimBusStats bus;
+static I2C_HandleTypeDef *tx_hi2c;  // prijenos u tijeku (0 = sabirnica slobodna)
+static uint64_t tx_done_at;         // kada prijenos završava (prekid)
+static SimLatency lat;
+static uint64_t press_at;           // vrijeme zadnjeg pritiska koji još čeka promjenu zaslona
+static int press_pending;
+
+static const uint8_t row_offsets[4] = {0x00, 0x40, 0x14, 0x54};
+
+// Sabirnica i mjerenja kreću od nule kod svakog reseta procesora
+static void sim_lcd_bus_reset(void) {
+    memset(&bus, 0, sizeof(bus));
+    memset(&lat, 0, sizeof(lat));
+    tx_hi2c = 0;
+    tx_done_at = 0;
+    press_pending = 0;
+}
+
+// Nestanak napajanja: zasloni se gase (ponovno se priključuju sa sim_lcd_attach)
+void sim_lcd_reset(void) {
+    if (!lcds) {
+        lcds = mmap(NULL, SIM_MAX_LCDS * sizeof(*lcds), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (lcds == MAP_FAILED) abort();
+    }
+    memset(lcds, 0, SIM_MAX_LCDS * sizeof(*lcds));
+    sim_lcd_bus_reset();
+}
+
+// Reset procesora: LCD zadržava DDRAM, CGRAM, način rada i eventualno pola primljenog
+// bajta; sat kreće od nule, a LCD je već dulje uključen
+void sim_lcd_warm_reset(void) {
+    for (int i = 0; lcds && i < SIM_MAX_LCDS; i++) {
+        lcds[i].busy_until = 0;
+        lcds[i].violations = 0;
+        lcds[i].first_pixel = 0;
+        lcds[i].ready_at = 0;
+        lcds[i].watch = 0;
+        lcds[i].watch_at = 0;
+    }
+    sim_lcd_bus_reset();
+}
+
+// Već priključen zaslon (nakon sim_warm_reset) ostaje kakav jest
+void sim_lcd_attach(uint8_t addr, uint8_t cols, uint8_t rows) {
+    for (int i = 0; i < SIM_MAX_LCDS; i++) {
+        if (lcds[i].used && lcds[i].addr == addr) return;
+    }
+    for (int i = 0; i < SIM_MAX_LCDS; i++) {
+        if (lcds[i].used) continue;
+        lcds[i].used = 1;
+        lcds[i].addr = addr;
+        lcds[i].cols = cols;
+        lcds[i].rows = rows;
+        lcds[i].ready_at = SIM_LCD_POWER_US;
+        memset(lcds[i].ddram, ' ', sizeof(lcds[i].ddram));  // nakon uključenja DDRAM je "prazan"
+        return;
+    }
+}
+
+static SimLcd *sim_lcd_find(uint8_t addr) {
+    for (int i = 0; i < SIM_MAX_LCDS; i++) {
+        if (lcds[i].used && lcds[i].addr == addr) return &lcds[i];
+    }
+    return 0;
+}
+
+// --- Kašnjenje od pritiska do piksela ---
+void sim_latency_press(uint64_t t_us) {
+    if (press_pending) lat.missed++;         // prethodni pritisak nije promijenio zaslon
+    press_at = t_us;
+    press_pending = 1;
+}
+
+void sim_latency_pixel(uint64_t t_us) {
+    if (!press_pending || t_us < press_at) return;
+    uint64_t d = t_us - press_at;
+    lat.count++;
+    lat.sum_us += d;
+    if (d > lat.max_us) lat.max_us = d;
+    press_pending = 0;
+}
+
+const SimLatency *sim_latency(void) {
+    return &lat;
+}
+
+const SimBusStats *sim_bus_stats(void) {
+    return &bus;
+}
+
+// --- Je li DDRAM adresa vidljiva na zaslonu? ---
+static int sim_lcd_visible(const SimLcd *l, uint8_t a) {
+    for (int r = 0; r < l->rows; r++) {
+        if (a >= row_offsets[r] && a < row_offsets[r] + l->cols) return 1;
+    }
+    return 0;
+}
+
+static void sim_lcd_pixel(SimLcd *l, uint64_t t) {
+    if (!l->display_on) return;
+    if (!l->first_pixel) l->first_pixel = t;
+    sim_latency_pixel(t);
+}
+
+// Upis u red 'a': je li u njemu sada praćeni tekst
+static void sim_lcd_check_watch(SimLcd *l, uint8_t a, uint64_t t) {
+    if (!l->watch || l->watch_at || !l->display_on) return;
+    uint8_t base = row_offsets[l->watch_row];
+    size_t n = strlen(l->watch);
+    if (a < base || a >= base + l->cols || n > l->cols) return;
+    if (memcmp(&l->ddram[base], l->watch, n) == 0) l->watch_at = t;
+}
+
+// --- Pomak brojača adrese nakon upisa (2-redni način: 0x00–0x27 i 0x40–0x67) ---
+static void sim_lcd_ac_step(SimLcd *l) {
+    if (l->ac_cgram) {
+        l->ac = (l->ac + 1) & 0x3F;
+        return;
+    }
+    l->ac++;
+    if (l->ac == 0x28) l->ac = 0x40;
+    else if (l->ac == 0x68) l->ac = 0x00;
+}
+
+// --- Izvrši jednu naredbu ili upis podatka ---
+static void sim_lcd_exec(SimLcd *l, uint8_t val, uint8_t rs, uint64_t t) {
+    if (t < l->ready_at || t < l->busy_until) l->violations++;
+    uint64_t exec = SIM_LCD_EXEC_US;
+
+    if (rs) {                                        // upis podatka
+        if (l->ac_cgram) {
+            l->cgram[l->ac & 0x3F] = val & 0x1F;
+        } else {
+            if (l->ddram[l->ac] != val && sim_lcd_visible(l, l->ac)) {
+                l->ddram[l->ac] = val;
+                sim_lcd_pixel(l, t);
+            }
+            l->ddram[l->ac] = val;
+            sim_lcd_check_watch(l, l->ac, t);
+        }
+        sim_lcd_ac_step(l);
+        exec = SIM_LCD_DATA_US;
+    } else if (val & 0x80) {                         // set DDRAM address
+        l->ac = val & 0x7F;
+        l->ac_cgram = 0;
+    } else if (val & 0x40) {                         // set CGRAM address
+        l->ac = val & 0x3F;
+        l->ac_cgram = 1;
+        bus.cgram_loads++;
+    } else if (val & 0x20) {                         // function set
+        if (!l->mode4 && (val & 0x10)) {             // 8-bitni reset slijed (0x30)
+            exec = (l->init_stage == 0) ? SIM_LCD_INIT1_US :
+                   (l->init_stage == 1) ? SIM_LCD_INIT2_US : SIM_LCD_EXEC_US;
+            l->init_stage++;
+        }
+        l->mode4 = (val & 0x10) ? 0 : 1;
+        l->have_hi = 0;
+    } else if (val & 0x08) {                         // display on/off
+        l->display_on = (val & 0x04) ? 1 : 0;
+    } else if (val & 0x04) {                         // entry mode set (smjer pomaka je uvijek udesno)
+    } else if (val & 0x02) {                         // return home
+        l->ac = 0;
+        l->ac_cgram = 0;
+        exec = SIM_LCD_CLEAR_US;
+    } else if (val & 0x01) {                         // clear display
+        int changed = 0;
+        for (int a = 0; a < 128; a++) {
+            if (l->ddram[a] != ' ' && sim_lcd_visible(l, a)) changed = 1;
+        }
+        memset(l->ddram, ' ', sizeof(l->ddram));
+        l->ac = 0;
+        l->ac_cgram = 0;
+        if (changed) sim_lcd_pixel(l, t);
+        exec = SIM_LCD_CLEAR_US;
+    }
+    l->busy_until = t + exec;
+}
+
+// --- Jedan bajt upisan u PCF8574 u trenutku t ---
+static void sim_lcd_port_write(SimLcd *l, uint8_t b, uint64_t t) {
+    uint8_t prev = l->prev;
+    l->prev = b;
+    if (!(prev & 0x04) || (b & 0x04)) return;        // samo silazni brid E
+    if (prev & 0x02) return;                         // RW = 1 → čitanje, ovdje ga ne modeliramo
+
+    uint8_t nibble = prev & 0xF0;
+    uint8_t rs = prev & 0x01;
+    if (!l->mode4) {                                 // 8-bitni način: nibble je cijela naredba
+        sim_lcd_exec(l, nibble, rs, t);
+        return;
+    }
+    if (!l->have_hi) {
+        l->hi = nibble;
+        l->have_hi = 1;
+        return;
+    }
+    l->have_hi = 0;
+    sim_lcd_exec(l, l->hi | (nibble >> 4), rs, t);
+}
+
+// --- Prijenos na sabirnici: vrati trajanje i dekodiraj bajtove ---
+// Bajt na I2C-u traje 9 taktova (8 bitova + ACK), plus start i stop.
+static uint64_t sim_i2c_xfer(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint64_t start) {
+    uint32_t speed = hi2c->Init.ClockSpeed ? hi2c->Init.ClockSpeed : 100000;
+    double bit_us = 1e6 / speed;
+    SimLcd *l = sim_lcd_find((uint8_t)(DevAddress >> 1));
+
+    for (uint16_t i = 0; l && i < Size; i++) {
+        uint64_t t = start + (uint64_t)(bit_us * (1 + 9 * (i + 2)));
+        sim_lcd_port_write(l, pData[i], t);
+    }
+    uint64_t dur = (uint64_t)(bit_us * (2 + 9 * (Size + 1)));
+    bus.transfers++;
+    bus.bytes += Size;
+    bus.bus_us += dur;
+    return dur;
+}
+
+// Kao HAL na F4: Standard mode traži PCLK1 od barem 2 MHz, Fast mode barem 4 MHz
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    if (pclk1 < 2000000U || hi2c->Init.ClockSpeed > 400000U) return HAL_ERROR;
+    if (hi2c->Init.ClockSpeed > 100000U && pclk1 < 4000000U) return HAL_ERROR;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+    return HAL_OK;
+}
+
+uint64_t sim_i2c_irq_at(void) {
+    return tx_hi2c ? tx_done_at : 0;
+}
+
+void sim_i2c_irq(void) {
+    I2C_HandleTypeDef *h = tx_hi2c;
+    tx_hi2c = 0;
+    HAL_I2C_MasterTxCpltCallback(h);
+}
+
+void sim_i2c_stall(uint64_t us) {
+    bus.cpu_stall_us += us;
+}
+
+// Kao HAL: dok DMA/IT prijenos traje, periferija je zauzeta (HAL_BUSY)
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    (void)Timeout;
+    if (tx_hi2c) return HAL_BUSY;
+    uint64_t dur = sim_i2c_xfer(hi2c, DevAddress, pData, Size, sim_now_us());
+    bus.cpu_stall_us += dur;
+    sim_advance_us(dur);                             // blokirajući prijenos: CPU čeka cijelo vrijeme
+    return sim_lcd_find((uint8_t)(DevAddress >> 1)) ? HAL_OK : HAL_ERROR;
+}
+
+// DMA/IT: bajtovi se dekodiraju odmah s vremenima u budućnosti, a kraj prijenosa se
+// javlja kao prekid (HAL_I2C_MasterTxCpltCallback) kad virtualni sat dođe do njega.
+static HAL_StatusTypeDef sim_i2c_async(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+    if (tx_hi2c) return HAL_BUSY;
+    if (!sim_lcd_find((uint8_t)(DevAddress >> 1))) return HAL_ERROR;
+    uint64_t start = sim_now_us();
+    tx_done_at = start + sim_i2c_xfer(hi2c, DevAddress, pData, Size, start);
+    tx_hi2c = hi2c;
+    sim_advance_us(SIM_COST_I2C_START_US);           // pokretanje DMA kanala
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+    return sim_i2c_async(hi2c, DevAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size) {
+    return sim_i2c_async(hi2c, DevAddress, pData, Size);
+}
+
+__attribute__((weak)) void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+}
+
+__attribute__((weak)) void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+}
+
+// --- Čitanje virtualnog zaslona ---
+void sim_lcd_line(uint8_t addr, uint8_t row, char *out) {
+    SimLcd *l = sim_lcd_find(addr);
+    if (!l || row >= l->rows) {
+        out[0] = '\0';
+        return;
+    }
+    for (int c = 0; c < l->cols; c++) {
+        uint8_t ch = l->ddram[row_offsets[row] + c];
+        out[c] = (ch < 0x10) ? '~' : (char)ch;       // CGRAM znakovi (0x00–0x0F)
+    }
+    out[l->cols] = '\0';
+}
+
+uint32_t sim_lcd_violations(uint8_t addr) {
+    SimLcd *l = sim_lcd_find(addr);
+    return l ? l->violations : 0;
+}
+
+uint64_t sim_lcd_first_pixel_us(uint8_t addr) {
+    SimLcd *l = sim_lcd_find(addr);
+    return l ? l->first_pixel : 0;
+}
+
+void sim_lcd_watch(uint8_t addr, uint8_t row, const char *text) {
+    SimLcd *l = sim_lcd_find(addr);
+    if (!l || row >= l->rows) return;
+    l->watch = text;
+    l->watch_row = row;
+    l->watch_at = 0;
+}
+
+uint64_t sim_lcd_watch_us(uint8_t addr) {
+    SimLcd *l = sim_lcd_find(addr);
+    return l ? l->watch_at : 0;
+}
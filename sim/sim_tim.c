@@ -0,0 +1,293 @@
+#include "sim.h"
+#include "tim.h"
+#include <string.h>
+
+// --- Model TIM1 s tri DMA toka (uzorci LED-a i buzzera) ---
+// Brojilo se ne vrti tik po tik nego perioda po periodu: na kraju svake periode
+// usporedbe CH1/CH2 (ako su u periodi) pokreću svoje DMA tokove prema GPIOA->BSRR,
+// a svjetlina LED-a (CCR4 / (ARR + 1)) se pribraja vremenu upaljenog LED-a.
+// Update događaj dolazi tek nakon RCR + 1 perioda: tada se preload registri
+// prepišu u aktivne, DMA burst upiše sljedeći korak u preload, a one-pulse mod
+// zaustavlja brojilo. Kraj bursta je prekid (HAL_TIM_PeriodElapsedCallback).
+
+TIM_TypeDef sim_tim1;
+TIM_HandleTypeDef htim1;
+DMA_Stream_TypeDef sim_dma2_stream1;
+DMA_Stream_TypeDef sim_dma2_stream2;
+DMA_Stream_TypeDef sim_dma2_stream5;
+DMA_HandleTypeDef hdma_tim1_ch1;
+DMA_HandleTypeDef hdma_tim1_ch2;
+DMA_HandleTypeDef hdma_tim1_up;
+TIM_TypeDef sim_tim5;
+TIM_HandleTypeDef htim5;
+
+// Aktivni (shadow) registri; firmware piše samo u preload (sim_tim1)
+static struct {
+    uint32_t psc, arr, ccr1, ccr2, ccr4;
+} act;
+static uint32_t rep;             // preostale periode do update događaja
+static int running;              // brojilo broji (CEN viđen u sim_tim_sync)
+static uint64_t period_end;      // kraj trenutne periode
+static uint64_t hold_from;       // od kada se broji vrijeme dok brojilo stoji
+static int irq_pending;          // DMA burst je gotov, prekid čeka
+static SimSignalStats sig;
+
+// --- Model TIM5 (32-bitno slobodno brojilo) ---
+// CNT se ne sprema nego računa iz virtualnog sata kod svakog READ_REG čitanja,
+// s preskalerom koji je vrijedio od zadnjeg update događaja (UG) i trenutnim
+// taktom timera na APB1.
+static uint64_t tim5_epoch;      // trenutak zadnjeg UG-a (brojilo je tada bilo 0)
+static uint32_t tim5_psc;        // aktivni preskaler (preload se prepisuje kod UG-a)
+
+void sim_tim_reset(void) {
+    memset(&sim_tim1, 0, sizeof(sim_tim1));
+    memset(&sim_dma2_stream1, 0, sizeof(sim_dma2_stream1));
+    memset(&sim_dma2_stream2, 0, sizeof(sim_dma2_stream2));
+    memset(&sim_dma2_stream5, 0, sizeof(sim_dma2_stream5));
+    memset(&act, 0, sizeof(act));
+    memset(&sig, 0, sizeof(sig));
+    rep = 0;
+    running = 0;
+    period_end = 0;
+    hold_from = 0;
+    irq_pending = 0;
+    memset(&sim_tim5, 0, sizeof(sim_tim5));
+    tim5_epoch = 0;
+    tim5_psc = 0;
+}
+
+const SimSignalStats *sim_signal_stats(void) {
+    sim_tim_sync(sim_now_us());
+    return &sig;
+}
+
+// --- Zamjena za CubeMX tim.c: TIM1 PWM CH4 + DMA2 Stream1/2/5 ---
+void MX_TIM1_Init(void) {
+    htim1.Instance = TIM1;
+    htim1.Init.Prescaler = 15;
+    htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim1.Init.Period = 999;
+    htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim1.Init.RepetitionCounter = 0;
+    htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    sim_tim1.PSC = htim1.Init.Prescaler;
+    sim_tim1.ARR = htim1.Init.Period;
+    sim_tim1.CR1 = htim1.Init.AutoReloadPreload;
+    sim_tim1.CCMR2 = (TIM_OCMODE_PWM1 << 8) | TIM_CCMR2_OC4PE;
+
+    hdma_tim1_ch1.Instance = &sim_dma2_stream1;
+    hdma_tim1_ch1.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tim1_ch1.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_tim1_ch1.Init.Mode = DMA_CIRCULAR;
+    hdma_tim1_ch2 = hdma_tim1_ch1;
+    hdma_tim1_ch2.Instance = &sim_dma2_stream2;
+    hdma_tim1_up.Instance = &sim_dma2_stream5;
+    hdma_tim1_up.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tim1_up.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_tim1_up.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_tim1_up.Init.Mode = DMA_NORMAL;
+    htim1.hdma[TIM_DMA_ID_CC1] = &hdma_tim1_ch1;
+    htim1.hdma[TIM_DMA_ID_CC2] = &hdma_tim1_ch2;
+    htim1.hdma[TIM_DMA_ID_UPDATE] = &hdma_tim1_up;
+    hdma_tim1_ch1.Parent = &htim1;
+    hdma_tim1_ch2.Parent = &htim1;
+    hdma_tim1_up.Parent = &htim1;
+}
+
+// --- Zamjena za CubeMX tim.c: TIM5 bez kanala i prekida ---
+void MX_TIM5_Init(void) {
+    htim5.Instance = TIM5;
+    htim5.Init.Prescaler = 0;
+    htim5.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim5.Init.Period = 0xFFFFFFFFU;
+    htim5.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    sim_tim5.PSC = htim5.Init.Prescaler;
+    sim_tim5.ARR = htim5.Init.Period;
+}
+
+// Vrijednost brojila TIM5; svako čitanje traje SIM_COST_TIM_READ_US, pa petlja
+// koja čeka na brojilo pomiče virtualni sat
+uint32_t sim_tim5_count(void) {
+    sim_advance_us(SIM_COST_TIM_READ_US);
+    if (!(sim_tim5.CR1 & TIM_CR1_CEN)) return sim_tim5.CNT;
+    uint64_t ticks = (sim_now_us() - tim5_epoch) * sim_apb1_timer_hz() / 1000000u / (tim5_psc + 1u);
+    return sim_tim5.CNT + (uint32_t)ticks;
+}
+
+// UG: preskaler iz preloada, brojilo od nule
+static void sim_tim5_update(void) {
+    tim5_psc = sim_tim5.PSC;
+    tim5_epoch = sim_now_us();
+    sim_tim5.CNT = 0;
+}
+
+// --- DMA ---
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength) {
+    if (hdma->Instance->CR & DMA_SxCR_EN) return HAL_BUSY;
+    hdma->Instance->M0AR = SrcAddress;
+    hdma->Instance->PAR = DstAddress;
+    hdma->Instance->NDTR = DataLength;
+    hdma->Instance->CR |= DMA_SxCR_EN;
+    sim_advance_us(SIM_COST_I2C_START_US);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    hdma->Instance->CR &= ~DMA_SxCR_EN;
+    return HAL_OK;
+}
+
+// Jedan zahtjev kružnog toka od jedne riječi (CC1/CC2 → GPIOA->BSRR)
+static void sim_dma_word(DMA_HandleTypeDef *hdma) {
+    DMA_Stream_TypeDef *s = hdma->Instance;
+    if (!(s->CR & DMA_SxCR_EN)) return;
+    sim_write_reg((volatile uint32_t *)s->PAR, *(const uint32_t *)s->M0AR);
+}
+
+// Update zahtjev s DCR burstom: DBL + 1 poluriječi od DBA nadalje
+static void sim_dma_burst(void) {
+    DMA_Stream_TypeDef *s = hdma_tim1_up.Instance;
+    if (!(s->CR & DMA_SxCR_EN) || !(sim_tim1.DIER & TIM_DIER_UDE)) return;
+    volatile uint32_t *regs = &sim_tim1.CR1;
+    uint32_t base = sim_tim1.DCR & 0x1Fu;
+    uint32_t len = ((sim_tim1.DCR >> 8) & 0x1Fu) + 1u;
+    const uint16_t *src = (const uint16_t *)s->M0AR;
+    for (uint32_t i = 0; i < len && s->NDTR; i++) {
+        regs[base + i] = *src++;
+        s->NDTR--;
+    }
+    s->M0AR = (uintptr_t)src;
+    if (s->NDTR == 0) {                      // normalni mod: tok se gasi, stiže prekid
+        s->CR &= ~DMA_SxCR_EN;
+        irq_pending = 1;
+    }
+}
+
+// --- Brojilo ---
+static uint64_t sim_tim_period_us(void) {
+    return (uint64_t)(act.arr + 1u) * (act.psc + 1u) * 1000000u / sim_apb2_timer_hz();
+}
+
+// Update događaj: preload → aktivni registri, zatim DMA burst i one-pulse
+static void sim_tim_update(void) {
+    act.psc = sim_tim1.PSC;
+    act.arr = sim_tim1.ARR;
+    act.ccr1 = sim_tim1.CCR1;
+    act.ccr2 = sim_tim1.CCR2;
+    act.ccr4 = sim_tim1.CCR4;
+    rep = sim_tim1.RCR & 0xFFu;
+    sim_tim1.CNT = 0;
+    sim_dma_burst();
+}
+
+// Kraj jedne periode brojila u trenutku period_end
+static void sim_tim_period(void) {
+    uint64_t us = sim_tim_period_us();
+    int set = (sim_tim1.DIER & TIM_DIER_CC1DE) && act.ccr1 <= act.arr;
+    int clr = (sim_tim1.DIER & TIM_DIER_CC2DE) && act.ccr2 <= act.arr;
+    if (set) sim_dma_word(&hdma_tim1_ch1);   // CC1: PA12 HIGH
+    if (clr) sim_dma_word(&hdma_tim1_ch2);   // CC2: PA12 LOW
+    if (set && clr) sig.tone_us += us;
+    if ((sim_tim1.CCER & TIM_CCER_CC4E) && (sim_tim1.BDTR & TIM_BDTR_MOE) &&
+        (sim_tim1.CCMR2 & TIM_CCMR2_OC4M) == (TIM_OCMODE_PWM1 << 8)) {
+        uint32_t duty = act.ccr4 > act.arr + 1u ? act.arr + 1u : act.ccr4;
+        sig.led_us += us * duty / (act.arr + 1u);
+    }
+
+    if (rep) {                               // ponavljanje: još periode do update događaja
+        rep--;
+    } else {
+        if (sim_tim1.CR1 & TIM_CR1_OPM) sim_tim1.CR1 &= ~TIM_CR1_CEN;
+        sim_tim_update();
+    }
+    if (sim_tim1.CR1 & TIM_CR1_CEN) {
+        period_end += sim_tim_period_us();
+    } else {
+        running = 0;
+        hold_from = period_end;
+    }
+}
+
+// Uskladi model s registrima koje je firmware upravo promijenio (CEN) i pribroji
+// vrijeme upaljenog LED-a dok brojilo stoji (CH4 u prisilnom stanju)
+void sim_tim_sync(uint64_t now) {
+    if (running && !(sim_tim1.CR1 & TIM_CR1_CEN)) {   // firmware je zaustavio brojilo
+        running = 0;
+        hold_from = now;
+    }
+    if (!running) {
+        if ((sim_tim1.CCER & TIM_CCER_CC4E) && (sim_tim1.BDTR & TIM_BDTR_MOE) &&
+            (sim_tim1.CCMR2 & TIM_CCMR2_OC4M) == (TIM_OCMODE_FORCED_ACTIVE << 8)) {
+            sig.led_us += now - hold_from;
+        }
+        hold_from = now;
+    }
+    if (!running && (sim_tim1.CR1 & TIM_CR1_CEN)) {   // firmware je pokrenuo brojilo
+        running = 1;
+        period_end = now + sim_tim_period_us();
+    }
+}
+
+// Sljedeći trenutak kad se u TIM1 nešto događa (0 = brojilo stoji)
+uint64_t sim_tim_event_at(void) {
+    return running ? period_end : 0;
+}
+
+// Obradi sve periode koje su završile do 'now'
+void sim_tim_advance(uint64_t now) {
+    while (running && period_end <= now) sim_tim_period();
+}
+
+int sim_tim_irq_pending(void) {
+    return irq_pending;
+}
+
+void sim_tim_irq(void) {
+    irq_pending = 0;
+    sig.patterns++;
+    HAL_TIM_PeriodElapsedCallback(&htim1);
+}
+
+// STOP: takt timera stoji; ako uzorak još svira, to je greška firmware-a
+void sim_tim_stop_mode(void) {
+    if (sim_tim1.CR1 & TIM_CR1_CEN) sig.stop_running++;
+}
+
+// --- HAL TIM ---
+HAL_StatusTypeDef HAL_TIM_DMABurst_MultiWriteStart(TIM_HandleTypeDef *htim, uint32_t BurstBaseAddress,
+                                                   uint32_t BurstRequestSrc, uint32_t *BurstBuffer,
+                                                   uint32_t BurstLength, uint32_t DataLength) {
+    htim->Instance->DCR = BurstBaseAddress | BurstLength;
+    if (HAL_DMA_Start(htim->hdma[TIM_DMA_ID_UPDATE], (uintptr_t)BurstBuffer,
+                      (uintptr_t)&htim->Instance->DMAR, DataLength) != HAL_OK) return HAL_ERROR;
+    htim->Instance->DIER |= BurstRequestSrc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef *htim, uint32_t BurstRequestSrc) {
+    htim->Instance->DIER &= ~BurstRequestSrc;
+    return HAL_DMA_Abort(htim->hdma[TIM_DMA_ID_UPDATE]);
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim) {
+    if (htim->Instance == TIM5 && !(sim_tim5.CR1 & TIM_CR1_CEN)) {
+        sim_tim5.CNT = sim_tim5_count();     // brojilo nastavlja od vrijednosti na kojoj je stalo
+        tim5_epoch = sim_now_us();
+    }
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *htim, uint32_t EventSource) {
+    if (htim->Instance == TIM5 && (EventSource & TIM_EGR_UG)) sim_tim5_update();
+    if (htim->Instance != TIM1 || !(EventSource & TIM_EGR_UG)) return HAL_OK;
+    uint64_t now = sim_now_us();
+    sim_tim_sync(now);
+    sim_tim_update();                        // UG: preload → aktivni, DMA zahtjev, brojilo od nule
+    if (running) period_end = now + sim_tim_period_us();
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    (void)htim;
+}
@@ -0,0 +1,85 @@
+#include "sim.h"
+#include "usart.h"
+#include <string.h>
+
+// --- Model USART2 s DMA prijenosom ---
+// Bajtovi se odmah kopiraju u zapisnik, a prijenos "traje" 10 bitova po bajtu.
+// Kraj prijenosa se javlja kao prekid (HAL_UART_TxCpltCallback) u pravom trenutku
+// virtualnog sata, pa firmware mora čekati callback kao i na pločici.
+
+USART_TypeDef sim_usart2;
+UART_HandleTypeDef huart2;
+
+#define SIM_UART_LOG_SIZE 65536
+
+static uint8_t uart_log[SIM_UART_LOG_SIZE];
+static uint32_t uart_len;
+static UART_HandleTypeDef *tx_huart;   // prijenos u tijeku (0 = UART slobodan)
+static uint64_t tx_done_at;            // kada prijenos završava
+
+void sim_uart_reset(void) {
+    uart_len = 0;
+    tx_huart = 0;
+    tx_done_at = 0;
+}
+
+const uint8_t *sim_uart_data(uint32_t *len) {
+    *len = uart_len;
+    return uart_log;
+}
+
+uint64_t sim_uart_irq_at(void) {
+    return tx_huart ? tx_done_at : 0;
+}
+
+void sim_uart_irq(void) {
+    UART_HandleTypeDef *h = tx_huart;
+    tx_huart = 0;
+    HAL_UART_TxCpltCallback(h);
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart) {
+    (void)huart;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart) {
+    if (tx_huart == huart) tx_huart = 0;   // prekinuti prijenos se ne javlja
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    if (tx_huart) return HAL_BUSY;
+    if (Size == 0 || huart->Init.BaudRate == 0) return HAL_ERROR;
+
+    uint32_t n = Size;
+    if (n > SIM_UART_LOG_SIZE - uart_len) n = SIM_UART_LOG_SIZE - uart_len;
+    memcpy(uart_log + uart_len, pData, n);
+    uart_len += n;
+
+    sim_advance_us(SIM_COST_I2C_START_US);   // pokretanje DMA kanala
+    tx_huart = huart;
+    tx_done_at = sim_now_us() + ((uint64_t)Size * 10 * 1000000 + huart->Init.BaudRate - 1) / huart->Init.BaudRate;
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+// --- Zamjena za CubeMX usart.c ---
+void MX_USART2_UART_Init(void) {
+    huart2.Instance = USART2;
+    huart2.Init.BaudRate = 115200;
+    huart2.Init.WordLength = UART_WORDLENGTH_8B;
+    huart2.Init.StopBits = UART_STOPBITS_1;
+    huart2.Init.Parity = UART_PARITY_NONE;
+    huart2.Init.Mode = UART_MODE_TX_RX;
+    huart2.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    huart2.Init.OverSampling = UART_OVERSAMPLING_16;
+    HAL_UART_Init(&huart2);
+}
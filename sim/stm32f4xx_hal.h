@@ -0,0 +1,508 @@
+#ifndef __SIM_STM32F4XX_HAL_H__   // Zamjenski (mock) HAL za simulator na računalu
+#define __SIM_STM32F4XX_HAL_H__
+
+// --- Mock stm32f4xx_hal.h ---
+// Sadrži samo ono što firmware koristi, s istim imenima i potpisima kao pravi
+// STM32Cube HAL. Implementacija je u sim_hal.c, sim_lcd.c, sim_uart.c i sim_tim.c:
+// virtualni sat umjesto SysTick-a, skriptirana tipkovnica umjesto GPIO-a,
+// PCF8574/HD44780 dekoder umjesto I2C sabirnice, model UART-a i TIM1 s DMA-om.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+
+// --- Opći tipovi ---
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+// --- Cortex-M intrinzici (na računalu su to obični pozivi ili barijere) ---
+#define __DMB()         __sync_synchronize()
+#define __NOP()         ((void)0)
+#define __CLZ(x)        ((uint8_t)((x) ? __builtin_clz(x) : 32))
+#define __disable_irq() sim_disable_irq()
+#define __enable_irq()  sim_enable_irq()
+#define __WFI()         sim_wfi()
+void sim_disable_irq(void);
+void sim_enable_irq(void);
+void sim_wfi(void);
+
+// --- GPIO ---
+typedef struct {
+    __IO uint32_t MODER;
+    __IO uint32_t OTYPER;
+    __IO uint32_t OSPEEDR;
+    __IO uint32_t PUPDR;
+    __IO uint32_t IDR;
+    __IO uint32_t ODR;
+    __IO uint32_t BSRR;
+    __IO uint32_t LCKR;
+    __IO uint32_t AFR[2];
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef sim_gpioa;
+extern GPIO_TypeDef sim_gpiob;
+extern GPIO_TypeDef sim_gpioc;
+#define GPIOA (&sim_gpioa)
+#define GPIOB (&sim_gpiob)
+#define GPIOC (&sim_gpioc)
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_1   ((uint16_t)0x0002)
+#define GPIO_PIN_2   ((uint16_t)0x0004)
+#define GPIO_PIN_3   ((uint16_t)0x0008)
+#define GPIO_PIN_4   ((uint16_t)0x0010)
+#define GPIO_PIN_5   ((uint16_t)0x0020)
+#define GPIO_PIN_6   ((uint16_t)0x0040)
+#define GPIO_PIN_7   ((uint16_t)0x0080)
+#define GPIO_PIN_8   ((uint16_t)0x0100)
+#define GPIO_PIN_9   ((uint16_t)0x0200)
+#define GPIO_PIN_10  ((uint16_t)0x0400)
+#define GPIO_PIN_11  ((uint16_t)0x0800)
+#define GPIO_PIN_12  ((uint16_t)0x1000)
+#define GPIO_PIN_13  ((uint16_t)0x2000)
+#define GPIO_PIN_14  ((uint16_t)0x4000)
+#define GPIO_PIN_15  ((uint16_t)0x8000)
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+// --- CMSIS pristup registrima ---
+// Na pločici su ovo obični upisi i čitanja, a simulator ih presreće kako bi
+// upis u BSRR promijenio ODR, a čitanje IDR-a vidjelo trenutno stanje tipki.
+#define WRITE_REG(REG, VAL) sim_write_reg(&(REG), (uint32_t)(VAL))
+#define SET_BIT(REG, BIT)   ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) ((REG) = (((REG) & ~(CLEARMASK)) | (SETMASK)))
+#define READ_REG(REG)       sim_read_reg(&(REG))
+void sim_write_reg(volatile uint32_t *reg, uint32_t val);
+uint32_t sim_read_reg(volatile uint32_t *reg);
+
+// --- DWT brojač ciklusa ---
+// CYCCNT se ne sprema nego računa iz virtualnog sata kod svakog READ_REG čitanja
+// (virtualni ciklusi = µs × SystemCoreClock / 1 MHz, zbrojeno po razdobljima između
+// promjena takta, pa brojač preko promjene profila samo raste; u STOP-u stoji).
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DHCSR;
+    __IO uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_coredebug;
+#define DWT        (&sim_dwt)
+#define CoreDebug  (&sim_coredebug)
+
+// --- Neovisni watchdog (IWDG) ---
+// Firmware ga ne pokreće; pin_store.c ga samo osvježava (KR = 0xAAAA) prije brisanja sektora.
+typedef struct {
+    __IO uint32_t KR;
+    __IO uint32_t PR;
+    __IO uint32_t RLR;
+    __IO uint32_t SR;
+} IWDG_TypeDef;
+
+extern IWDG_TypeDef sim_iwdg;
+#define IWDG       (&sim_iwdg)
+
+#define DWT_CTRL_CYCCNTENA_Msk        0x00000001U
+#define CoreDebug_DEMCR_TRCENA_Msk    0x01000000U
+
+// --- EXTI i SYSCFG ---
+typedef struct {
+    __IO uint32_t IMR;
+    __IO uint32_t EMR;
+    __IO uint32_t RTSR;
+    __IO uint32_t FTSR;
+    __IO uint32_t SWIER;
+    __IO uint32_t PR;
+} EXTI_TypeDef;
+
+typedef struct {
+    __IO uint32_t MEMRMP;
+    __IO uint32_t PMC;
+    __IO uint32_t EXTICR[4];
+    uint32_t RESERVED[2];
+    __IO uint32_t CMPCR;
+} SYSCFG_TypeDef;
+
+extern EXTI_TypeDef sim_exti;
+extern SYSCFG_TypeDef sim_syscfg;
+#define EXTI    (&sim_exti)
+#define SYSCFG  (&sim_syscfg)
+
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()  ((void)0)
+
+// --- I2C ---
+typedef struct {
+    uint32_t dummy;
+} I2C_TypeDef;
+
+extern I2C_TypeDef sim_i2c1;
+#define I2C1 (&sim_i2c1)
+
+typedef struct {
+    uint32_t ClockSpeed;
+    uint32_t DutyCycle;
+    uint32_t OwnAddress1;
+    uint32_t AddressingMode;
+    uint32_t DualAddressMode;
+    uint32_t OwnAddress2;
+    uint32_t GeneralCallMode;
+    uint32_t NoStretchMode;
+} I2C_InitTypeDef;
+
+typedef struct __I2C_HandleTypeDef {
+    I2C_TypeDef *Instance;
+    I2C_InitTypeDef Init;
+} I2C_HandleTypeDef;
+
+#define I2C_DUTYCYCLE_2              0x00000000U
+#define I2C_ADDRESSINGMODE_7BIT      0x00004000U
+#define I2C_DUALADDRESS_DISABLE      0x00000000U
+#define I2C_GENERALCALL_DISABLE      0x00000000U
+#define I2C_NOSTRETCH_DISABLE        0x00000000U
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+// --- UART ---
+typedef struct {
+    uint32_t dummy;
+} USART_TypeDef;
+
+extern USART_TypeDef sim_usart2;
+#define USART2 (&sim_usart2)
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+} UART_HandleTypeDef;
+
+#define UART_WORDLENGTH_8B           0x00000000U
+#define UART_STOPBITS_1              0x00000000U
+#define UART_PARITY_NONE             0x00000000U
+#define UART_MODE_TX_RX              0x0000000CU
+#define UART_HWCONTROL_NONE          0x00000000U
+#define UART_OVERSAMPLING_16         0x00000000U
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+// --- DMA (samo tok i handle, onoliko koliko trebaju TIM1 uzorci) ---
+// Adrese su uintptr_t jer su na računalu pokazivači 64-bitni (na pločici je to uint32_t).
+typedef struct {
+    __IO uint32_t CR;
+    __IO uint32_t NDTR;
+    __IO uintptr_t PAR;
+    __IO uintptr_t M0AR;
+    __IO uintptr_t M1AR;
+    __IO uint32_t FCR;
+} DMA_Stream_TypeDef;
+
+#define DMA_SxCR_EN                  0x00000001U
+
+typedef struct {
+    uint32_t Channel;
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+    DMA_Stream_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+    void *Parent;
+} DMA_HandleTypeDef;
+
+#define DMA_MEMORY_TO_PERIPH         0x00000040U
+#define DMA_MDATAALIGN_HALFWORD      0x00002000U
+#define DMA_MDATAALIGN_WORD          0x00004000U
+#define DMA_PDATAALIGN_HALFWORD      0x00000800U
+#define DMA_PDATAALIGN_WORD          0x00001000U
+#define DMA_NORMAL                   0x00000000U
+#define DMA_CIRCULAR                 0x00000100U
+#define DMA_MINC_ENABLE              0x00000400U
+#define DMA_MINC_DISABLE             0x00000000U
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+
+// --- TIM (napredni timer TIM1, raspored registara kao na pločici zbog DMA bursta) ---
+typedef struct {
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t SMCR;
+    __IO uint32_t DIER;
+    __IO uint32_t SR;
+    __IO uint32_t EGR;
+    __IO uint32_t CCMR1;
+    __IO uint32_t CCMR2;
+    __IO uint32_t CCER;
+    __IO uint32_t CNT;
+    __IO uint32_t PSC;
+    __IO uint32_t ARR;
+    __IO uint32_t RCR;
+    __IO uint32_t CCR1;
+    __IO uint32_t CCR2;
+    __IO uint32_t CCR3;
+    __IO uint32_t CCR4;
+    __IO uint32_t BDTR;
+    __IO uint32_t DCR;
+    __IO uint32_t DMAR;
+} TIM_TypeDef;
+
+extern TIM_TypeDef sim_tim1;
+extern TIM_TypeDef sim_tim5;
+#define TIM1 (&sim_tim1)
+#define TIM5 (&sim_tim5)   // 32-bitno brojilo za mikrosekundni sat (timebase.c); CNT se čita s READ_REG
+
+#define TIM_CR1_CEN                  0x00000001U
+#define TIM_CR1_OPM                  0x00000008U
+#define TIM_CR1_ARPE                 0x00000080U
+#define TIM_DIER_UDE                 0x00000100U
+#define TIM_DIER_CC1DE               0x00000200U
+#define TIM_DIER_CC2DE               0x00000400U
+#define TIM_EGR_UG                   0x00000001U
+#define TIM_CCMR2_OC4PE              0x00000800U
+#define TIM_CCMR2_OC4M               0x00007000U
+#define TIM_CCER_CC4E                0x00001000U
+#define TIM_BDTR_MOE                 0x00008000U
+
+#define TIM_OCMODE_FORCED_INACTIVE   0x00000040U
+#define TIM_OCMODE_FORCED_ACTIVE     0x00000050U
+#define TIM_OCMODE_PWM1              0x00000060U
+
+#define TIM_DMA_UPDATE               TIM_DIER_UDE
+#define TIM_DMA_CC1                  TIM_DIER_CC1DE
+#define TIM_DMA_CC2                  TIM_DIER_CC2DE
+#define TIM_DMA_ID_UPDATE            ((uint16_t)0x0000)
+#define TIM_DMA_ID_CC1               ((uint16_t)0x0001)
+#define TIM_DMA_ID_CC2               ((uint16_t)0x0002)
+#define TIM_DMA_ID_CC3               ((uint16_t)0x0003)
+#define TIM_DMA_ID_CC4               ((uint16_t)0x0004)
+#define TIM_DMA_ID_COMMUTATION       ((uint16_t)0x0005)
+#define TIM_DMA_ID_TRIGGER           ((uint16_t)0x0006)
+#define TIM_DMABASE_ARR              0x0000000BU
+#define TIM_DMABURSTLENGTH_6TRANSFERS 0x00000500U
+#define TIM_EVENTSOURCE_UPDATE       TIM_EGR_UG
+#define TIM_CHANNEL_4                0x0000000CU
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct __TIM_HandleTypeDef {
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+    DMA_HandleTypeDef *hdma[7];
+} TIM_HandleTypeDef;
+
+#define TIM_COUNTERMODE_UP           0x00000000U
+#define TIM_CLOCKDIVISION_DIV1       0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_ENABLE TIM_CR1_ARPE
+
+#define __HAL_TIM_ENABLE_DMA(h, d)   ((h)->Instance->DIER |= (d))
+#define __HAL_TIM_DISABLE_DMA(h, d)  ((h)->Instance->DIER &= ~(d))
+
+// Update DMA: kad burst prenese zadnji podatak, HAL zove HAL_TIM_PeriodElapsedCallback()
+// (kao prekid, iz sim_advance_us). Vrijeme tona i LED-a broji sim_tim.c.
+HAL_StatusTypeDef HAL_TIM_DMABurst_MultiWriteStart(TIM_HandleTypeDef *htim, uint32_t BurstBaseAddress,
+                                                   uint32_t BurstRequestSrc, uint32_t *BurstBuffer,
+                                                   uint32_t BurstLength, uint32_t DataLength);
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef *htim, uint32_t BurstRequestSrc);
+HAL_StatusTypeDef HAL_TIM_GenerateEvent(TIM_HandleTypeDef *htim, uint32_t EventSource);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+// --- Jezgra HAL-a ---
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+void HAL_SYSTICK_Callback(void);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+
+// --- RCC / PWR (samo ono što koristi SystemClock_Config) ---
+typedef struct {
+    uint32_t PLLState;
+    uint32_t PLLSource;
+    uint32_t PLLM;
+    uint32_t PLLN;
+    uint32_t PLLP;
+    uint32_t PLLQ;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+    uint32_t OscillatorType;
+    uint32_t HSEState;
+    uint32_t LSEState;
+    uint32_t HSIState;
+    uint32_t HSICalibrationValue;
+    uint32_t LSIState;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSI      0x00000002U
+#define RCC_HSI_ON                  0x00000001U
+#define RCC_HSICALIBRATION_DEFAULT  0x10U
+#define RCC_PLL_NONE                0x00000000U
+#define RCC_PLL_OFF                 0x00000001U
+#define RCC_PLL_ON                  0x00000002U
+#define RCC_PLLSOURCE_HSI           0x00000000U
+#define RCC_PLLP_DIV2               0x00000002U
+#define RCC_PLLP_DIV4               0x00000004U
+#define RCC_CLOCKTYPE_SYSCLK        0x00000001U
+#define RCC_CLOCKTYPE_HCLK          0x00000002U
+#define RCC_CLOCKTYPE_PCLK1         0x00000004U
+#define RCC_CLOCKTYPE_PCLK2         0x00000008U
+#define RCC_SYSCLKSOURCE_HSI        0x00000000U
+#define RCC_SYSCLKSOURCE_PLLCLK     0x00000002U
+#define RCC_SYSCLK_DIV1             1U
+#define RCC_SYSCLK_DIV2             2U
+#define RCC_SYSCLK_DIV4             4U
+#define RCC_SYSCLK_DIV8             8U
+#define RCC_HCLK_DIV1               1U
+#define RCC_HCLK_DIV2               2U
+#define RCC_HCLK_DIV4               4U
+#define FLASH_LATENCY_0             0U
+#define FLASH_LATENCY_1             1U
+#define FLASH_LATENCY_2             2U
+#define PWR_REGULATOR_VOLTAGE_SCALE2 0x00008000U
+#define PWR_REGULATOR_VOLTAGE_SCALE3 0x00004000U
+
+#define PWR_MAINREGULATOR_ON         0x00000000U
+#define PWR_LOWPOWERREGULATOR_ON     0x00000001U
+#define PWR_SLEEPENTRY_WFI           ((uint8_t)0x01)
+#define PWR_SLEEPENTRY_WFE           ((uint8_t)0x02)
+#define PWR_STOPENTRY_WFI            ((uint8_t)0x01)
+#define PWR_STOPENTRY_WFE            ((uint8_t)0x02)
+
+// Sleep: virtualni sat skoči na sljedeći prekid (SysTick ili UART).
+// STOP: sat ide od događaja do događaja iz skripte dok EXTI brid (EMR/IMR) ne probudi
+// procesor; nakon buđenja SystemCoreClock je HSI kao na pločici.
+void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry);
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry);
+
+#define __HAL_RCC_PWR_CLK_ENABLE()           ((void)0)
+
+// --- Uzrok reseta (RCC_CSR) ---
+// Nakon uključenja su postavljeni POR, BOR i PIN, a nakon reseta bez nestanka
+// napajanja (watchdog, NRST, softverski) samo zastavice tog uzroka, sve dok ih
+// firmware ne obriše. Vrijednosti su kao u HAL-u (donjih 5 bitova = bit u CSR-u).
+#define RCC_FLAG_BORRST              ((uint8_t)0x79)
+#define RCC_FLAG_PINRST              ((uint8_t)0x7A)
+#define RCC_FLAG_PORRST              ((uint8_t)0x7B)
+#define RCC_FLAG_SFTRST              ((uint8_t)0x7C)
+#define RCC_FLAG_IWDGRST             ((uint8_t)0x7D)
+#define RCC_FLAG_WWDGRST             ((uint8_t)0x7E)
+#define RCC_FLAG_LPWRRST             ((uint8_t)0x7F)
+#define __HAL_RCC_GET_FLAG(FLAG)             sim_rcc_flag(FLAG)
+#define __HAL_RCC_CLEAR_RESET_FLAGS()        sim_rcc_clear_reset_flags()
+int sim_rcc_flag(uint8_t flag);
+void sim_rcc_clear_reset_flags(void);
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(x)   ((void)(x))
+
+extern uint32_t SystemCoreClock;
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+// --- Flash (STM32F401xE: sektori 0–3 po 16 KB, sektor 4 od 64 KB, sektori 5–7 po 128 KB) ---
+// FLASH_BASE pokazuje na virtualni flash, pa adrese oblika FLASH_BASE + pomak rade
+// kao na pločici. Upis može samo brisati bitove (1 → 0), brisanje sektora vraća 0xFF.
+// FLASH_END je adresa na pločici (kao u stm32f401xe.h), iz nje flash_layout.h računa
+// veličinu; FLASHSIZE_BASE (veličina u KB koju čip javlja) pokazuje na varijablu.
+#define FLASH_END                   0x0807FFFFUL
+#define FLASH_SECTOR_TOTAL          8U
+#define SIM_FLASH_SIZE              (FLASH_END - 0x08000000UL + 1U)
+extern uint8_t *sim_flash;
+extern uint16_t sim_flash_size_kb;
+#define FLASH_BASE                  ((uintptr_t)sim_flash)
+#define FLASHSIZE_BASE              ((uintptr_t)&sim_flash_size_kb)
+
+#define FLASH_TYPEERASE_SECTORS     0x00000000U
+#define FLASH_TYPEPROGRAM_BYTE      0x00000000U
+#define FLASH_TYPEPROGRAM_HALFWORD  0x00000001U
+#define FLASH_TYPEPROGRAM_WORD      0x00000002U
+#define FLASH_VOLTAGE_RANGE_3       0x00000002U
+#define FLASH_BANK_1                1U
+#define FLASH_SECTOR_0              0U
+#define FLASH_SECTOR_1              1U
+#define FLASH_SECTOR_2              2U
+#define FLASH_SECTOR_3              3U
+#define FLASH_SECTOR_4              4U
+#define FLASH_SECTOR_5              5U
+#define FLASH_SECTOR_6              6U
+#define FLASH_SECTOR_7              7U
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t Sector;
+    uint32_t NbSectors;
+    uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError);
+
+#endif // __SIM_STM32F4XX_HAL_H__
@@ -0,0 +1,12 @@
+#ifndef __TIM_H__   // Zamjena za CubeMX tim.h u simulatoru
+#define __TIM_H__
+
+#include "main.h"
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim5;
+
+void MX_TIM1_Init(void);
+void MX_TIM5_Init(void);
+
+#endif // __TIM_H__
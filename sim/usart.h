@@ -0,0 +1,10 @@
+#ifndef __USART_H__   // Zamjena za CubeMX usart.h u simulatoru
+#define __USART_H__
+
+#include "main.h"
+
+extern UART_HandleTypeDef huart2;
+
+void MX_USART2_UART_Init(void);
+
+#endif // __USART_H__
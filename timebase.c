@@ -0,0 +1,32 @@
+#include "timebase.h"  // Uključujemo header file s deklaracijama i HAL funkcijama
+
+static TIM_HandleTypeDef *tb_htim;   // TIM5 handle (postavlja Timebase_Init)
+
+void Timebase_Init(TIM_HandleTypeDef *htim) {
+    tb_htim = htim;
+    Timebase_Retime();
+    HAL_TIM_Base_Start(htim);        // bez prekida: brojilo samo broji
+}
+
+// - Takt TIM5: PCLK1, ili 2 × PCLK1 kad je APB1 djelitelj veći od 1 (PCLK1 < HCLK)
+void Timebase_Retime(void) {
+    if (!tb_htim) return;
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    uint32_t tim_hz = (pclk1 < HAL_RCC_GetHCLKFreq()) ? 2U * pclk1 : pclk1;
+    TIMEBASE_TIM->PSC = tim_hz / TIMEBASE_TICK_HZ - 1U;
+    HAL_TIM_GenerateEvent(tb_htim, TIM_EVENTSOURCE_UPDATE);   // PSC vrijedi odmah, brojilo od nule
+}
+
+uint32_t Timebase_Now(void) {
+    return READ_REG(TIMEBASE_TIM->CNT);
+}
+
+void Timebase_Delay(uint32_t us) {
+    uint32_t start = Timebase_Now();
+    uint32_t elapsed;
+    while ((elapsed = Timebase_Now() - start) < us) {
+        if (us - elapsed > TIMEBASE_SLEEP_US) {
+            __WFI();                 // SysTick budi najkasnije za 1 ms, pa se ne prespava
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef __TIMEBASE_H__     // Ako __TIMEBASE_H__ nije već definiran...
+#define __TIMEBASE_H__     // ...definiraj ga (štiti od višestrukog uključivanja)
+
+// Potrebno zbog TIM tipova i HAL funkcija
+#include "stm32f4xx_hal.h"
+
+// --- Mikrosekundni sat (TIM5, 32-bitno slobodno brojilo) ---
+// HAL_Delay() broji cijele SysTick periode (i čeka barem jednu više), pa bi
+// naredba LCD-a koja traje 37 µs čekala 1–2 ms. TIM5 broji na 1 MHz i nikad se
+// ne zaustavlja, pa se čeka točno onoliko koliko treba.
+//
+// TIM5 je na APB1: uz djelitelj APB1 veći od 1 timer dobiva dvostruki PCLK1, pa
+// se preskaler računa iz HCLK-a i PCLK1 (CLOCK_IDLE: 4 MHz, CLOCK_BURST: 84 MHz).
+// Promjena profila takta ponovno ga podesi (Timebase_Retime) i vrati brojilo na
+// nulu, pa čekanje ne smije trajati preko promjene profila (čekanja su
+// blokirajuća i promjena se radi samo iz glavne petlje, pa se to ne događa).
+//
+// CubeMX: TIM5 Internal Clock, Counter Period 0xFFFFFFFF, bez prekida.
+// U STOP-u TIM5 stoji; brojilo služi samo za kratka čekanja dok jezgra radi.
+
+#define TIMEBASE_TIM          TIM5
+#define TIMEBASE_TICK_HZ      1000000U   // takt brojila nakon preskalera (1 µs)
+#define TIMEBASE_SLEEP_US     1000U      // dulje čekanje spava (WFI) do sljedećeg SysTicka
+
+// Prototipovi funkcija
+//
+// Timebase_Init()
+// - Podesi preskaler za trenutni takt i pokreće brojilo (htim = &htim5 iz CubeMX-a)
+//
+// Timebase_Retime()
+// - Preskaler iz novog takta APB1; poziva ga Clock_SetProfile()
+//
+// Timebase_Now()
+// - Trenutna vrijednost brojila u µs (preljev nakon ~71 min; razlika dviju
+//   vrijednosti je ispravna i preko preljeva)
+//
+// Timebase_Delay()
+// - Čeka najmanje 'us' mikrosekundi; do zadnje milisekunde spava (WFI), ostatak
+//   provjerava brojilo
+void Timebase_Init(TIM_HandleTypeDef *htim);
+void Timebase_Retime(void);
+uint32_t Timebase_Now(void);
+void Timebase_Delay(uint32_t us);
+
+#endif // __TIMEBASE_H__   // završetak zaštite od višestrukog uključivanja